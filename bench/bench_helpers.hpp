@@ -0,0 +1,85 @@
+#ifndef BENCH_HELPERS_hpp
+#define BENCH_HELPERS_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+    // \brief A hardware counter of this process (user space only) read through perf_event_open; reports itself unavailable on other platforms or when the kernel refuses it (see /proc/sys/kernel/perf_event_paranoid)
+    class perf_counter {
+        private:
+            int fd = -1;
+
+        public:
+            /** Open a hardware counter
+             * \param type The perf event type (e.g. PERF_TYPE_HARDWARE or PERF_TYPE_HW_CACHE)
+             * \param config The perf event config (e.g. PERF_COUNT_HW_CACHE_MISSES)
+             */
+            perf_counter(const std::uint32_t &type, const std::uint64_t &config) {
+                #ifdef __linux__
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = type;
+                attr.config = config;
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                this->fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+                #endif
+            }
+            perf_counter(const bench::perf_counter &) = delete;
+            bench::perf_counter& operator=(const bench::perf_counter &) = delete;
+            // \brief bench::perf_counter deconstructor; closes the counter
+            ~perf_counter() {
+                #ifdef __linux__
+                if (this->fd >= 0) {
+                    close(this->fd);
+                }
+                #endif
+            }
+
+            bool is_available() const {
+                return this->fd >= 0;
+            }
+            // \brief Reset the count to 0 and start counting
+            void start() {
+                #ifdef __linux__
+                if (this->fd >= 0) {
+                    ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+                #endif
+            }
+            /** Stop counting
+             * \returns The count since bench::perf_counter::start (0 if the counter is unavailable)
+             */
+            std::uint64_t stop() {
+                std::uint64_t output = 0;
+                #ifdef __linux__
+                if (this->fd >= 0) {
+                    ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0);
+                    if (read(this->fd, &output, sizeof(output)) != sizeof(output)) {
+                        output = 0;
+                    }
+                }
+                #endif
+                return output;
+            }
+    };
+
+    // \brief Get the time since an arbitrary point (ms)
+    inline double get_time() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+#endif // BENCH_HELPERS_hpp
@@ -0,0 +1,110 @@
+// Compares the memory layouts of bengine::grid_2d by casting the same rays through the same 4096x4096 map stored each way
+// Reports rays/sec along with cache misses per ray (read from hardware counters where the kernel allows it)
+// Usage: grid_layout_bench.out [rays per run]
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "bengine_grid.hpp"
+#include "bench_helpers.hpp"
+
+struct ray {
+    double x_pos;
+    double y_pos;
+    double angle;
+};
+
+struct run_result {
+    double rays_per_second;
+    // \brief Per ray (negative when the counter is unavailable)
+    double cache_misses;
+    double l1_misses;
+    std::vector<std::optional<bengine::grid_2d::ray_hit>> hits;
+};
+
+run_result run(const bengine::grid_2d &grid, const std::vector<ray> &rays, const double &range) {
+    run_result output;
+    output.hits.reserve(rays.size());
+    bench::perf_counter cache_misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    bench::perf_counter l1_misses(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+    cache_misses.start();
+    l1_misses.start();
+    const double start = bench::get_time();
+    for (const ray &current : rays) {
+        output.hits.emplace_back(grid.cast_ray(current.x_pos, current.y_pos, current.angle, range));
+    }
+    const double elapsed = bench::get_time() - start;
+    const std::uint64_t cache_miss_count = cache_misses.stop(), l1_miss_count = l1_misses.stop();
+
+    output.rays_per_second = rays.size() / (elapsed / 1000);
+    output.cache_misses = cache_misses.is_available() ? static_cast<double>(cache_miss_count) / rays.size() : -1;
+    output.l1_misses = l1_misses.is_available() ? static_cast<double>(l1_miss_count) / rays.size() : -1;
+    return output;
+}
+
+void print_counter(const double &value) {
+    if (value < 0) {
+        std::printf("%12s", "n/a");
+    } else {
+        std::printf("%12.1f", value);
+    }
+}
+
+int main(int argc, char* args[]) {
+    const std::size_t side_length = 4096;
+    const std::size_t ray_count = argc > 1 ? std::strtoul(args[1], nullptr, 10) : 20000;
+    const double range = side_length * 2;
+
+    std::printf("%zux%zu map, %zu rays per run from random open cells in random directions (unlimited range)\n\n", side_length, side_length, ray_count);
+    std::printf("%-10s %-10s %12s %12s %12s\n", "density", "layout", "rays/sec", "LLC miss/ray", "L1D miss/ray");
+
+    bool identical = true;
+    for (const double &density : {0.0005, 0.002, 0.02}) {
+        std::mt19937_64 generator(1234);
+        std::uniform_real_distribution<double> unit(0, 1);
+
+        std::vector<std::unique_ptr<bengine::grid_2d>> grids;
+        grids.emplace_back(std::make_unique<bengine::row_major_grid_2d>(side_length, side_length));
+        grids.emplace_back(std::make_unique<bengine::tiled_grid_2d>(side_length, side_length));
+        for (std::size_t row = 0; row < side_length; row++) {
+            for (std::size_t col = 0; col < side_length; col++) {
+                if (unit(generator) < density) {
+                    for (std::unique_ptr<bengine::grid_2d> &grid : grids) {
+                        grid->set_cell(col, row, 1);
+                    }
+                }
+            }
+        }
+
+        std::vector<ray> rays;
+        while (rays.size() < ray_count) {
+            const double x_pos = unit(generator) * side_length, y_pos = unit(generator) * side_length;
+            if (!grids[0]->is_solid(x_pos, y_pos)) {
+                rays.push_back({x_pos, y_pos, unit(generator) * C_2PI});
+            }
+        }
+
+        std::vector<run_result> results;
+        for (const std::unique_ptr<bengine::grid_2d> &grid : grids) {
+            results.push_back(run(*grid, rays, range));
+            std::printf("%-10.2f %-10s %12.0f", density * 100, grid->get_layout() == bengine::grid_2d::layout::ROW_MAJOR ? "row-major" : "tiled", results.back().rays_per_second);
+            print_counter(results.back().cache_misses);
+            print_counter(results.back().l1_misses);
+            std::printf("\n");
+        }
+
+        for (std::size_t i = 0; i < ray_count; i++) {
+            const std::optional<bengine::grid_2d::ray_hit> &lhs = results[0].hits[i], &rhs = results[1].hits[i];
+            if (lhs.has_value() != rhs.has_value() || (lhs.has_value() && (lhs.value().col != rhs.value().col || lhs.value().row != rhs.value().row))) {
+                identical = false;
+            }
+        }
+    }
+    std::printf("\n(density is the percentage of solid cells)\nBoth layouts hit the same cells: %s\n", identical ? "yes" : "NO");
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+// Compares bengine::sweep_and_prune_2d against brute force O(n^2) bengine::basic_collider_2d::detect_collision on a clustered crowd
+// The crowd is made of 8x3 gaussian clumps of 0.6-wide colliders that each move up to 0.05 per tick; timings are averaged over the ticks and the pair lists are checked against each other every tick
+// Usage: sweep_and_prune_bench.out [ticks per run]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "bengine_sweep_and_prune.hpp"
+#include "bench_helpers.hpp"
+
+int main(int argc, char* args[]) {
+    const std::size_t ticks = argc > 1 ? std::strtoul(args[1], nullptr, 10) : 10;
+
+    std::printf("8x3 gaussian clumps of 0.6x0.6 colliders moving up to 0.05 per tick, averaged over %zu ticks\n\n", ticks);
+    std::printf("%8s %10s %12s %16s %10s\n", "n", "pairs", "SAP ms/tick", "brute ms/tick", "speedup");
+
+    bool identical = true;
+    for (const std::size_t &size : {1000ul, 5000ul, 20000ul}) {
+        std::mt19937_64 generator(1234);
+        std::uniform_int_distribution<int> clump_col(0, 7), clump_row(0, 2);
+        std::normal_distribution<double> spread(0, 4);
+        std::uniform_real_distribution<double> step(-0.05, 0.05);
+
+        std::vector<bengine::basic_collider_2d> colliders;
+        for (std::size_t i = 0; i < size; i++) {
+            colliders.emplace_back(clump_col(generator) * 40 + spread(generator), clump_row(generator) * 40 + spread(generator), 0.6, 0.6);
+        }
+        bengine::sweep_and_prune_2d broadphase;
+        for (const bengine::basic_collider_2d &collider : colliders) {
+            broadphase.insert(collider);
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>> pairs, brute_pairs;
+        double sweep_time = 0, brute_time = 0;
+        // The first sweep sorts the endpoints from scratch, so it isn't timed
+        broadphase.find_pairs(pairs);
+        for (std::size_t tick = 0; tick < ticks; tick++) {
+            for (std::size_t i = 0; i < size; i++) {
+                colliders[i].set_x_pos(colliders[i].get_x_pos() + step(generator));
+                colliders[i].set_y_pos(colliders[i].get_y_pos() + step(generator));
+            }
+
+            double start = bench::get_time();
+            for (std::size_t i = 0; i < size; i++) {
+                broadphase.update(i, colliders[i]);
+            }
+            broadphase.find_pairs(pairs);
+            sweep_time += bench::get_time() - start;
+
+            start = bench::get_time();
+            brute_pairs.clear();
+            for (std::size_t i = 0; i < size; i++) {
+                for (std::size_t j = i + 1; j < size; j++) {
+                    if (colliders[i].detect_collision(colliders[j])) {
+                        brute_pairs.emplace_back(i, j);
+                    }
+                }
+            }
+            brute_time += bench::get_time() - start;
+
+            if (pairs != brute_pairs) {
+                identical = false;
+            }
+        }
+        std::printf("%8zu %10zu %12.2f %16.2f %9.1fx\n", size, pairs.size(), sweep_time / ticks, brute_time / ticks, brute_time / sweep_time);
+    }
+    std::printf("\nPair lists matched brute force on every tick: %s\n", identical ? "yes" : "NO");
+    return identical ? 0 : 1;
+}
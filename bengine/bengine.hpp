@@ -3,12 +3,30 @@
 
 #include "bengine_texture.hpp"
 #include "bengine_render_window.hpp"
+#include "bengine_tiled_canvas.hpp"
+#include "bengine_ray_fan.hpp"
+#include "bengine_glyph_atlas.hpp"
+#include "bengine_compositor.hpp"
+#include "bengine_resolution_scaler.hpp"
 #include "bengine_mouse.hpp"
 #include "bengine_loop.hpp"
 #include "bengine_helpers.hpp"
 #include "bengine_small_vector_2d.hpp"
 #include "bengine_fast_vector_2d.hpp"
+#include "bengine_grid.hpp"
 #include "bengine_colliders.hpp"
+#include "bengine_spatial_hash.hpp"
+#include "bengine_sweep_and_prune.hpp"
+#include "bengine_aabb_tree.hpp"
+#include "bengine_line_of_sight.hpp"
+#include "bengine_visibility.hpp"
+#include "bengine_lighting.hpp"
+#include "bengine_lightmap.hpp"
+#include "bengine_flood_light.hpp"
+#include "bengine_pathfinding.hpp"
+#include "bengine_flow_field.hpp"
+#include "bengine_worker_pool.hpp"
 #include "bengine_physics.hpp"
+#include "bengine_crowd.hpp"
 
 #endif // BENGINE_hpp
@@ -0,0 +1,450 @@
+#ifndef BENGINE_AABB_TREE_hpp
+#define BENGINE_AABB_TREE_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include "bengine_colliders.hpp"
+
+namespace bengine {
+    /** A bounding volume hierarchy for colliders that move every tick (NPCs, projectiles, etc)
+     *
+     * Each collider is stored with a slightly larger ("fat") box, so small movements don't change the tree at all; when a collider leaves its fat box it is reinserted, and the tree is rebalanced with rotations on the way back up
+     * Colliders are referred to through the IDs handed out when they are inserted; queries only read the tree, so several threads can query at once as long as nothing is modifying it
+     */
+    class aabb_tree_2d {
+        public:
+            // \brief The closest collider hit by a ray
+            struct ray_hit {
+                // \brief The ID of the collider that was hit
+                std::size_t id;
+                bengine::coordinate_2d<double> position;
+                // \brief How far the hit is from the start of the ray
+                double distance;
+            };
+
+            static constexpr std::size_t null_node = __SIZE_MAX__;
+
+        private:
+            struct node {
+                // \brief The fat box of a leaf, or the box enclosing both children of an internal node
+                double min_x, min_y, max_x, max_y;
+                // \brief The parent of the node, or the next free node if this node is unused
+                std::size_t parent;
+                std::size_t child_1, child_2;
+                // \brief 0 for leaves, -1 for unused nodes
+                long int height;
+                // \brief The actual bounds of a leaf's collider (unused by internal nodes)
+                bengine::basic_collider_2d collider;
+
+                bool is_leaf() const {
+                    return this->child_1 == bengine::aabb_tree_2d::null_node;
+                }
+            };
+
+            // \brief How far fat boxes extend past their colliders on every side (world units)
+            double margin = 0.1;
+            std::vector<bengine::aabb_tree_2d::node> nodes;
+            std::size_t root = bengine::aabb_tree_2d::null_node;
+            std::size_t free_list = bengine::aabb_tree_2d::null_node;
+            std::size_t leaf_count = 0;
+
+            // \brief The amount of nodes a query can have waiting on the stack before it has to allocate; an AVL-style balanced tree of any realistic size never gets close to this
+            static constexpr std::size_t max_stack_size = 256;
+
+            // \brief The nodes waiting to be visited by a query; it lives on the querying thread's stack (several threads can query one tree at once, see bengine::line_of_sight_2d) and only spills onto the heap past bengine::aabb_tree_2d::max_stack_size, so no subtree is ever skipped
+            struct traversal_stack {
+                std::size_t nodes[bengine::aabb_tree_2d::max_stack_size];
+                std::size_t size = 0;
+                std::vector<std::size_t> overflow;
+
+                bool is_empty() const {
+                    return this->size == 0 && this->overflow.empty();
+                }
+                void push(const std::size_t &index) {
+                    if (this->size < bengine::aabb_tree_2d::max_stack_size) {
+                        this->nodes[this->size++] = index;
+                    } else {
+                        this->overflow.push_back(index);
+                    }
+                }
+                // \brief The overflow only fills once the array is full, so popping it first keeps the order last in, first out
+                std::size_t pop() {
+                    if (!this->overflow.empty()) {
+                        const std::size_t output = this->overflow.back();
+                        this->overflow.pop_back();
+                        return output;
+                    }
+                    return this->nodes[--this->size];
+                }
+            };
+
+            std::size_t allocate_node() {
+                if (this->free_list == bengine::aabb_tree_2d::null_node) {
+                    this->nodes.emplace_back();
+                    this->free_list = this->nodes.size() - 1;
+                    this->nodes.back().parent = bengine::aabb_tree_2d::null_node;
+                }
+                const std::size_t index = this->free_list;
+                bengine::aabb_tree_2d::node &node = this->nodes[index];
+                this->free_list = node.parent;
+                node.parent = bengine::aabb_tree_2d::null_node;
+                node.child_1 = bengine::aabb_tree_2d::null_node;
+                node.child_2 = bengine::aabb_tree_2d::null_node;
+                node.height = 0;
+                return index;
+            }
+            void free_node(const std::size_t &index) {
+                this->nodes[index].parent = this->free_list;
+                this->nodes[index].height = -1;
+                this->free_list = index;
+            }
+
+            // \brief Half the perimeter of a box, which is what the tree tries to keep small when picking where to insert (the 2D equivalent of surface area)
+            static double get_cost(const double &min_x, const double &min_y, const double &max_x, const double &max_y) {
+                return (max_x - min_x) + (max_y - min_y);
+            }
+            double get_combined_cost(const std::size_t &index_1, const std::size_t &index_2) const {
+                const bengine::aabb_tree_2d::node &node_1 = this->nodes[index_1];
+                const bengine::aabb_tree_2d::node &node_2 = this->nodes[index_2];
+                return bengine::aabb_tree_2d::get_cost(std::min(node_1.min_x, node_2.min_x), std::min(node_1.min_y, node_2.min_y), std::max(node_1.max_x, node_2.max_x), std::max(node_1.max_y, node_2.max_y));
+            }
+            // \brief Recalculate the box/height of an internal node from its children
+            void refit(const std::size_t &index) {
+                bengine::aabb_tree_2d::node &node = this->nodes[index];
+                const bengine::aabb_tree_2d::node &child_1 = this->nodes[node.child_1];
+                const bengine::aabb_tree_2d::node &child_2 = this->nodes[node.child_2];
+                node.min_x = std::min(child_1.min_x, child_2.min_x);
+                node.min_y = std::min(child_1.min_y, child_2.min_y);
+                node.max_x = std::max(child_1.max_x, child_2.max_x);
+                node.max_y = std::max(child_1.max_y, child_2.max_y);
+                node.height = 1 + std::max(child_1.height, child_2.height);
+            }
+            void set_fat_box(const std::size_t &index, const double &x_motion, const double &y_motion) {
+                bengine::aabb_tree_2d::node &node = this->nodes[index];
+                node.min_x = node.collider.get_left_x() - this->margin + std::min(0.0, x_motion);
+                node.min_y = node.collider.get_bottom_y() - this->margin + std::min(0.0, y_motion);
+                node.max_x = node.collider.get_right_x() + this->margin + std::max(0.0, x_motion);
+                node.max_y = node.collider.get_top_y() + this->margin + std::max(0.0, y_motion);
+            }
+            // \brief Replace one child of a node with another (or the root, if the node has no parent)
+            void replace_child(const std::size_t &parent, const std::size_t &old_child, const std::size_t &new_child) {
+                if (parent == bengine::aabb_tree_2d::null_node) {
+                    this->root = new_child;
+                } else if (this->nodes[parent].child_1 == old_child) {
+                    this->nodes[parent].child_1 = new_child;
+                } else {
+                    this->nodes[parent].child_2 = new_child;
+                }
+            }
+
+            /** If one child of a node is more than one level taller than the other, rotate the taller child's children so that the subtree is balanced again
+             * \param index The node to balance
+             * \returns The node that now sits where the given node was
+             */
+            std::size_t balance(const std::size_t &index) {
+                bengine::aabb_tree_2d::node &node = this->nodes[index];
+                if (node.is_leaf() || node.height < 2) {
+                    return index;
+                }
+                const std::size_t child_1 = node.child_1, child_2 = node.child_2;
+                const long int difference = this->nodes[child_2].height - this->nodes[child_1].height;
+                if (difference >= -1 && difference <= 1) {
+                    return index;
+                }
+
+                // The taller child takes the node's place, the node takes one of the taller child's children, and the taller child keeps its taller grandchild
+                const std::size_t taller = difference > 1 ? child_2 : child_1;
+                const std::size_t shorter = difference > 1 ? child_1 : child_2;
+                const std::size_t grandchild_1 = this->nodes[taller].child_1, grandchild_2 = this->nodes[taller].child_2;
+                const bool keep_first = this->nodes[grandchild_1].height > this->nodes[grandchild_2].height;
+                const std::size_t kept = keep_first ? grandchild_1 : grandchild_2;
+                const std::size_t moved = keep_first ? grandchild_2 : grandchild_1;
+
+                this->nodes[taller].parent = node.parent;
+                this->replace_child(node.parent, index, taller);
+                node.parent = taller;
+                this->nodes[taller].child_1 = index;
+                this->nodes[taller].child_2 = kept;
+                node.child_1 = shorter;
+                node.child_2 = moved;
+                this->nodes[moved].parent = index;
+
+                this->refit(index);
+                this->refit(taller);
+                return taller;
+            }
+            // \brief Refit (and rebalance) every node from the given one up to the root
+            void fix_upwards(std::size_t index) {
+                while (index != bengine::aabb_tree_2d::null_node) {
+                    index = this->balance(index);
+                    this->refit(index);
+                    index = this->nodes[index].parent;
+                }
+            }
+
+            void insert_leaf(const std::size_t &leaf) {
+                if (this->root == bengine::aabb_tree_2d::null_node) {
+                    this->root = leaf;
+                    this->nodes[leaf].parent = bengine::aabb_tree_2d::null_node;
+                    return;
+                }
+
+                // Walk down towards whichever child would grow the least by taking in the leaf, stopping once pairing the leaf with the current node is cheaper than going further
+                std::size_t sibling = this->root;
+                while (!this->nodes[sibling].is_leaf()) {
+                    const bengine::aabb_tree_2d::node &node = this->nodes[sibling];
+                    const double combined_cost = this->get_combined_cost(sibling, leaf);
+                    const double pair_cost = 2 * combined_cost;
+                    // Any node below this one makes this node grow too
+                    const double inherited_cost = 2 * (combined_cost - bengine::aabb_tree_2d::get_cost(node.min_x, node.min_y, node.max_x, node.max_y));
+
+                    double child_costs[2];
+                    const std::size_t children[2] = {node.child_1, node.child_2};
+                    for (unsigned char i = 0; i < 2; i++) {
+                        const bengine::aabb_tree_2d::node &child = this->nodes[children[i]];
+                        child_costs[i] = this->get_combined_cost(children[i], leaf) + inherited_cost;
+                        if (!child.is_leaf()) {
+                            child_costs[i] -= bengine::aabb_tree_2d::get_cost(child.min_x, child.min_y, child.max_x, child.max_y);
+                        }
+                    }
+                    if (pair_cost < child_costs[0] && pair_cost < child_costs[1]) {
+                        break;
+                    }
+                    sibling = child_costs[0] < child_costs[1] ? children[0] : children[1];
+                }
+
+                const std::size_t old_parent = this->nodes[sibling].parent;
+                const std::size_t new_parent = this->allocate_node();
+                this->nodes[new_parent].parent = old_parent;
+                this->nodes[new_parent].child_1 = sibling;
+                this->nodes[new_parent].child_2 = leaf;
+                this->replace_child(old_parent, sibling, new_parent);
+                this->nodes[sibling].parent = new_parent;
+                this->nodes[leaf].parent = new_parent;
+                this->fix_upwards(new_parent);
+            }
+            void remove_leaf(const std::size_t &leaf) {
+                if (leaf == this->root) {
+                    this->root = bengine::aabb_tree_2d::null_node;
+                    return;
+                }
+                const std::size_t parent = this->nodes[leaf].parent;
+                const std::size_t grandparent = this->nodes[parent].parent;
+                const std::size_t sibling = this->nodes[parent].child_1 == leaf ? this->nodes[parent].child_2 : this->nodes[parent].child_1;
+
+                // The leaf's parent is no longer needed, so the sibling takes its place
+                this->replace_child(grandparent, parent, sibling);
+                this->nodes[sibling].parent = grandparent;
+                this->free_node(parent);
+                this->fix_upwards(grandparent);
+            }
+
+            /** Find how far along a ray it first enters a box (slab test)
+             * \returns The distance, or a negative value if the ray misses the box within the given range (a ray starting inside the box enters it at 0)
+             */
+            static double get_entry_distance(const double &x_pos, const double &y_pos, const double &x_inverse, const double &y_inverse, const bool &x_zero, const bool &y_zero, const double &range, const double &min_x, const double &min_y, const double &max_x, const double &max_y) {
+                double near = 0, far = range;
+                if (x_zero) {
+                    if (x_pos < min_x || x_pos > max_x) {
+                        return -1;
+                    }
+                } else {
+                    const double t_1 = (min_x - x_pos) * x_inverse, t_2 = (max_x - x_pos) * x_inverse;
+                    near = std::max(near, std::min(t_1, t_2));
+                    far = std::min(far, std::max(t_1, t_2));
+                }
+                if (y_zero) {
+                    if (y_pos < min_y || y_pos > max_y) {
+                        return -1;
+                    }
+                } else {
+                    const double t_1 = (min_y - y_pos) * y_inverse, t_2 = (max_y - y_pos) * y_inverse;
+                    near = std::max(near, std::min(t_1, t_2));
+                    far = std::min(far, std::max(t_1, t_2));
+                }
+                return near <= far ? near : -1;
+            }
+
+        public:
+            /** bengine::aabb_tree_2d constructor
+             * \param margin How far fat boxes extend past their colliders (world units); larger margins mean fewer reinsertions but looser boxes
+             */
+            aabb_tree_2d(const double &margin = 0.1) {
+                this->margin = margin < 0 ? 0 : margin;
+            }
+
+            double get_margin() const {
+                return this->margin;
+            }
+            // \brief Get the amount of colliders currently stored
+            std::size_t get_size() const {
+                return this->leaf_count;
+            }
+            // \brief Get the height of the tree (0 for a single collider or an empty tree)
+            long int get_height() const {
+                return this->root == bengine::aabb_tree_2d::null_node ? 0 : this->nodes[this->root].height;
+            }
+            bool contains(const std::size_t &id) const {
+                return id < this->nodes.size() && this->nodes[id].height == 0;
+            }
+            const bengine::basic_collider_2d &get_collider(const std::size_t &id) const {
+                return this->nodes.at(id).collider;
+            }
+
+            /** Add a collider to the tree
+             * \param collider The collider to add
+             * \returns The ID that the collider can be referred to with from now on
+             */
+            std::size_t insert(const bengine::basic_collider_2d &collider) {
+                const std::size_t id = this->allocate_node();
+                this->nodes[id].collider = collider;
+                this->set_fat_box(id, 0, 0);
+                this->insert_leaf(id);
+                this->leaf_count++;
+                return id;
+            }
+            /** Remove a collider from the tree (its ID may be handed out again by a later insertion)
+             * \param id The ID of the collider
+             */
+            void remove(const std::size_t &id) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                this->remove_leaf(id);
+                this->free_node(id);
+                this->leaf_count--;
+            }
+            /** Move/resize a collider; the tree is only changed if the collider leaves its fat box (or the fat box has become much bigger than the collider)
+             * \param id The ID of the collider
+             * \param collider The new bounds of the collider
+             * \param x_motion How far the collider is expected to move horizontally before its next update; the fat box is stretched in that direction to avoid reinsertions
+             * \param y_motion How far the collider is expected to move vertically before its next update
+             * \returns Whether the collider had to be reinserted
+             */
+            bool update(const std::size_t &id, const bengine::basic_collider_2d &collider, const double &x_motion = 0, const double &y_motion = 0) {
+                if (!this->contains(id)) {
+                    return false;
+                }
+                bengine::aabb_tree_2d::node &node = this->nodes[id];
+                node.collider = collider;
+                const bool is_inside = collider.get_left_x() >= node.min_x && collider.get_bottom_y() >= node.min_y && collider.get_right_x() <= node.max_x && collider.get_top_y() <= node.max_y;
+                // A fat box left over from a much bigger (or much faster) collider would make every query near it slower
+                const double loose_margin = 4 * this->margin;
+                const bool is_loose = node.min_x < collider.get_left_x() - loose_margin + std::min(0.0, x_motion) || node.min_y < collider.get_bottom_y() - loose_margin + std::min(0.0, y_motion) || node.max_x > collider.get_right_x() + loose_margin + std::max(0.0, x_motion) || node.max_y > collider.get_top_y() + loose_margin + std::max(0.0, y_motion);
+                if (is_inside && !is_loose) {
+                    return false;
+                }
+                this->remove_leaf(id);
+                this->set_fat_box(id, x_motion, y_motion);
+                this->insert_leaf(id);
+                return true;
+            }
+            // \brief Remove every collider from the tree
+            void clear() {
+                this->nodes.clear();
+                this->root = bengine::aabb_tree_2d::null_node;
+                this->free_list = bengine::aabb_tree_2d::null_node;
+                this->leaf_count = 0;
+            }
+
+            /** Find every collider overlapping an area
+             * \param bounds The area to search
+             * \param ids Where the IDs of the overlapping colliders are written (cleared first, sorted in ascending order)
+             */
+            void query_aabb(const bengine::basic_collider_2d &bounds, std::vector<std::size_t> &ids) const {
+                ids.clear();
+                if (this->root == bengine::aabb_tree_2d::null_node) {
+                    return;
+                }
+                bengine::aabb_tree_2d::traversal_stack stack;
+                stack.push(this->root);
+                while (!stack.is_empty()) {
+                    const bengine::aabb_tree_2d::node &node = this->nodes[stack.pop()];
+                    if (node.max_x < bounds.get_left_x() || node.min_x > bounds.get_right_x() || node.max_y < bounds.get_bottom_y() || node.min_y > bounds.get_top_y()) {
+                        continue;
+                    }
+                    if (node.is_leaf()) {
+                        if (node.collider.detect_collision(bounds)) {
+                            ids.emplace_back(&node - this->nodes.data());
+                        }
+                    } else {
+                        stack.push(node.child_1);
+                        stack.push(node.child_2);
+                    }
+                }
+                std::sort(ids.begin(), ids.end());
+            }
+
+            /** Find the closest collider along a ray, skipping any colliders rejected by a filter
+             * \param x_pos The x-position that the ray starts at
+             * \param y_pos The y-position that the ray starts at
+             * \param angle The direction of the ray (radians)
+             * \param range How far the ray goes
+             * \param is_ignored A function given a collider's ID that returns whether the collider should be skipped
+             * \returns The closest hit (a ray starting inside a collider hits it where it starts), or std::nullopt if nothing is hit within range; ties go to the lowest ID
+             */
+            template <class filter_type> std::optional<bengine::aabb_tree_2d::ray_hit> cast_ray_filtered(const double &x_pos, const double &y_pos, const double &angle, const double &range, const filter_type &is_ignored) const {
+                if (this->root == bengine::aabb_tree_2d::null_node || range < 0) {
+                    return std::nullopt;
+                }
+                const double x_dir = std::cos(angle), y_dir = std::sin(angle);
+                // Directions within rounding error of an axis are treated as exactly along it
+                const bool x_zero = std::fabs(x_dir) < 1e-12, y_zero = std::fabs(y_dir) < 1e-12;
+                const double x_inverse = x_zero ? 0 : 1 / x_dir, y_inverse = y_zero ? 0 : 1 / y_dir;
+
+                std::optional<bengine::aabb_tree_2d::ray_hit> output = std::nullopt;
+                double closest = range;
+                bengine::aabb_tree_2d::traversal_stack stack;
+                stack.push(this->root);
+                while (!stack.is_empty()) {
+                    const std::size_t index = stack.pop();
+                    const bengine::aabb_tree_2d::node &node = this->nodes[index];
+                    // Subtrees that the ray only reaches past the closest hit so far can't contain anything closer
+                    if (bengine::aabb_tree_2d::get_entry_distance(x_pos, y_pos, x_inverse, y_inverse, x_zero, y_zero, closest, node.min_x, node.min_y, node.max_x, node.max_y) < 0) {
+                        continue;
+                    }
+                    if (!node.is_leaf()) {
+                        stack.push(node.child_1);
+                        stack.push(node.child_2);
+                        continue;
+                    }
+                    if (is_ignored(index)) {
+                        continue;
+                    }
+                    const double distance = bengine::aabb_tree_2d::get_entry_distance(x_pos, y_pos, x_inverse, y_inverse, x_zero, y_zero, closest, node.collider.get_left_x(), node.collider.get_bottom_y(), node.collider.get_right_x(), node.collider.get_top_y());
+                    if (distance < 0 || (output.has_value() && (distance > output.value().distance || (distance == output.value().distance && index > output.value().id)))) {
+                        continue;
+                    }
+                    closest = distance;
+                    output = bengine::aabb_tree_2d::ray_hit{index, bengine::coordinate_2d<double>(x_pos + x_dir * distance, y_pos + y_dir * distance), distance};
+                }
+                return output;
+            }
+            /** Find the closest collider along a ray
+             * \param x_pos The x-position that the ray starts at
+             * \param y_pos The y-position that the ray starts at
+             * \param angle The direction of the ray (radians)
+             * \param range How far the ray goes
+             * \param ignored_id A collider to skip (e.g. the one belonging to whatever is casting the ray)
+             * \returns The closest hit (a ray starting inside a collider hits it where it starts), or std::nullopt if nothing is hit within range; ties go to the lowest ID
+             */
+            std::optional<bengine::aabb_tree_2d::ray_hit> cast_ray(const double &x_pos, const double &y_pos, const double &angle, const double &range, const std::optional<std::size_t> &ignored_id = std::nullopt) const {
+                return this->cast_ray_filtered(x_pos, y_pos, angle, range, [&](const std::size_t &id) {
+                    return ignored_id.has_value() && ignored_id.value() == id;
+                });
+            }
+            /** Find the closest collider hit by a hitscanner
+             * \param hitscanner The hitscanner to cast
+             * \param ignored_id A collider to skip (e.g. the one belonging to whatever is firing)
+             * \returns The closest hit, or std::nullopt if nothing is hit within the hitscanner's range
+             */
+            std::optional<bengine::aabb_tree_2d::ray_hit> get_hit(const bengine::hitscanner_2d &hitscanner, const std::optional<std::size_t> &ignored_id = std::nullopt) const {
+                return this->cast_ray(hitscanner.get_x_pos(), hitscanner.get_y_pos(), hitscanner.get_angle(), hitscanner.has_infinite_range() ? __DBL_MAX__ : hitscanner.get_range(), ignored_id);
+            }
+    };
+}
+
+#endif // BENGINE_AABB_TREE_hpp
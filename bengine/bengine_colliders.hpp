@@ -7,6 +7,8 @@
 
 #include "bengine_helpers.hpp"
 #include "bengine_coordinate_2d.hpp"
+#include "bengine_fast_vector_2d.hpp"
+#include "bengine_grid.hpp"
 
 namespace bengine {
     class basic_collider_2d {
@@ -17,6 +19,16 @@ namespace bengine {
                 MOVE_BOTH = 2
             };
 
+            // \brief Information about when and where a moving collider first touches another one
+            struct sweep_hit {
+                // \brief The fraction of the movement (0 to 1) completed at the moment of impact
+                double time;
+                // \brief x-component of the surface normal that was hit (-1, 0, or 1)
+                double normal_x;
+                // \brief y-component of the surface normal that was hit (-1, 0, or 1)
+                double normal_y;
+            };
+
         protected:
             bengine::coordinate_2d<double> position = bengine::coordinate_2d<double>(0, 0);
             double width_2 = 0;
@@ -125,6 +137,35 @@ namespace bengine {
                 return !(this->get_right_x() < other.get_left_x() || this->get_left_x() > other.get_right_x() || this->get_top_y() < other.get_bottom_y() || this->get_bottom_y() > other.get_top_y());
             }
 
+            /** Find when the collider would first touch another (stationary) collider while moving in a straight line (swept AABB)
+             * \param other The collider that might be hit
+             * \param x_motion How far the collider moves horizontally
+             * \param y_motion How far the collider moves vertically
+             * \returns The time/normal of the impact, or std::nullopt if the colliders never touch during the movement or are already overlapping before it
+             */
+            std::optional<bengine::basic_collider_2d::sweep_hit> sweep(const bengine::basic_collider_2d &other, const double &x_motion, const double &y_motion) const {
+                // Along an axis without motion, the colliders have to already overlap on that axis for an impact to be possible at all
+                if ((x_motion == 0 && (this->get_right_x() <= other.get_left_x() || this->get_left_x() >= other.get_right_x())) || (y_motion == 0 && (this->get_top_y() <= other.get_bottom_y() || this->get_bottom_y() >= other.get_top_y()))) {
+                    return std::nullopt;
+                }
+
+                // The times at which the colliders start/stop overlapping along each axis
+                const double x_entry = x_motion == 0 ? -__DBL_MAX__ : (x_motion > 0 ? other.get_left_x() - this->get_right_x() : other.get_right_x() - this->get_left_x()) / x_motion;
+                const double x_exit = x_motion == 0 ? __DBL_MAX__ : (x_motion > 0 ? other.get_right_x() - this->get_left_x() : other.get_left_x() - this->get_right_x()) / x_motion;
+                const double y_entry = y_motion == 0 ? -__DBL_MAX__ : (y_motion > 0 ? other.get_bottom_y() - this->get_top_y() : other.get_top_y() - this->get_bottom_y()) / y_motion;
+                const double y_exit = y_motion == 0 ? __DBL_MAX__ : (y_motion > 0 ? other.get_top_y() - this->get_bottom_y() : other.get_bottom_y() - this->get_top_y()) / y_motion;
+
+                const double entry = std::fmax(x_entry, y_entry);
+                const double exit = std::fmin(x_exit, y_exit);
+                if (entry > exit || entry < 0 || entry > 1) {
+                    return std::nullopt;
+                }
+                if (x_entry > y_entry) {
+                    return bengine::basic_collider_2d::sweep_hit{entry, x_motion > 0 ? -1.0 : 1.0, 0};
+                }
+                return bengine::basic_collider_2d::sweep_hit{entry, 0, y_motion > 0 ? -1.0 : 1.0};
+            }
+
             /** Fix the collision between two colliders so that they are no longer colliding
              * \param other The other bengine::basic_collider_2d that is being collided with
              * \param fix_mode The way that the collision should be fixed (mainly with the movement of either colliders)
@@ -317,6 +358,13 @@ namespace bengine {
                 }
                 return output;
             }
+            std::optional<bengine::coordinate_2d<double>> get_hit(const bengine::grid_2d &grid) const {
+                const std::optional<bengine::grid_2d::ray_hit> hit = grid.cast_ray(this->get_x_pos(), this->get_y_pos(), this->get_angle(), this->has_infinite_range() ? __DBL_MAX__ : this->get_range());
+                if (!hit.has_value()) {
+                    return std::nullopt;
+                }
+                return hit.value().position;
+            }
     };
 }
 
@@ -0,0 +1,196 @@
+#ifndef BENGINE_COMPOSITOR_hpp
+#define BENGINE_COMPOSITOR_hpp
+
+#include <algorithm>
+#include <vector>
+
+#include "bengine_render_window.hpp"
+
+namespace bengine {
+    /** Layers of a frame (e.g. the world, minimap, HUD, debug screen) that are each rendered onto their own texture and then stacked onto the window
+     *
+     * Each layer keeps what it last rendered until it is invalidated (as a whole or just part of it), so a change to one layer only re-renders that layer; every other layer costs a single texture copy
+     */
+    class compositor {
+        private:
+            struct layer {
+                SDL_Texture *texture = nullptr;
+                // \brief The size of the texture (px)
+                int texture_width = 0;
+                int texture_height = 0;
+                // \brief The resolution the layer is rendered at, or 0 to match the window (px)
+                int width = 0;
+                int height = 0;
+                bool visible = true;
+                bool dirty = true;
+                // \brief The part of the layer that needs to be re-rendered, if only part of it does (px relative to the window)
+                bool has_dirty_area = false;
+                SDL_Rect dirty_area = {};
+            };
+
+            std::vector<bengine::compositor::layer> layers;
+            // \brief The size of the window that the layers were last rendered for (px)
+            int width = 0;
+            int height = 0;
+            // \brief How many layers have been re-rendered since the last call to bengine::compositor::get_redraw_count
+            std::size_t redraw_count = 0;
+
+        public:
+            compositor() {}
+            compositor(const bengine::compositor &) = delete;
+            bengine::compositor& operator=(const bengine::compositor &) = delete;
+            // \brief bengine::compositor deconstructor; destroys every layer's texture
+            ~compositor() {
+                for (bengine::compositor::layer &current : this->layers) {
+                    SDL_DestroyTexture(current.texture);
+                }
+            }
+
+            /** Add a layer on top of every existing layer
+             * \returns The index of the layer
+             */
+            std::size_t add_layer() {
+                this->layers.emplace_back();
+                return this->layers.size() - 1;
+            }
+            std::size_t get_layer_count() const {
+                return this->layers.size();
+            }
+
+            bool is_visible(const std::size_t &layer) const {
+                return this->layers[layer].visible;
+            }
+            // \brief Show or hide a layer (hidden layers are not rendered or stacked, and showing a layer re-renders it)
+            void set_visible(const std::size_t &layer, const bool &visible) {
+                if (visible && !this->layers[layer].visible) {
+                    this->invalidate(layer);
+                }
+                this->layers[layer].visible = visible;
+            }
+            bool is_dirty(const std::size_t &layer) const {
+                return this->layers[layer].dirty;
+            }
+            // \brief Mark a whole layer as needing to be re-rendered
+            void invalidate(const std::size_t &layer) {
+                this->layers[layer].dirty = true;
+                this->layers[layer].has_dirty_area = false;
+            }
+            /** Mark part of a layer as needing to be re-rendered (the layer's textures are cleared and rendering is clipped to the smallest rectangle containing every invalidated part)
+             * \param layer The index of the layer
+             * \param area The part of the layer to re-render relative to the window (px for all 4 metrics) (layers with a resolution of their own are re-rendered whole)
+             */
+            void invalidate(const std::size_t &layer, const SDL_Rect &area) {
+                bengine::compositor::layer &current = this->layers[layer];
+                if (current.width > 0) {
+                    this->invalidate(layer);
+                } else if (!current.dirty) {
+                    current.dirty = true;
+                    current.has_dirty_area = true;
+                    current.dirty_area = area;
+                } else if (current.has_dirty_area) {
+                    const int right = std::max(current.dirty_area.x + current.dirty_area.w, area.x + area.w), bottom = std::max(current.dirty_area.y + current.dirty_area.h, area.y + area.h);
+                    current.dirty_area.x = std::min(current.dirty_area.x, area.x);
+                    current.dirty_area.y = std::min(current.dirty_area.y, area.y);
+                    current.dirty_area.w = right - current.dirty_area.x;
+                    current.dirty_area.h = bottom - current.dirty_area.y;
+                }
+            }
+            /** Render a layer at a resolution other than the window's (e.g. a lower one for the parts of the frame that are expensive to fill); it is drawn in its own pixels and stretched over the whole window when stacked
+             * \param layer The index of the layer
+             * \param width The width to render the layer at (px) (0 to match the window)
+             * \param height The height to render the layer at (px) (0 to match the window)
+             */
+            void set_resolution(const std::size_t &layer, const int &width, const int &height) {
+                bengine::compositor::layer &current = this->layers[layer];
+                if (current.width != width || current.height != height) {
+                    current.width = width;
+                    current.height = height;
+                    this->invalidate(layer);
+                }
+            }
+            // \brief Get the width that a layer is rendered at (px)
+            int get_width(const std::size_t &layer) const {
+                return this->layers[layer].width > 0 ? this->layers[layer].width : this->width;
+            }
+            // \brief Get the height that a layer is rendered at (px)
+            int get_height(const std::size_t &layer) const {
+                return this->layers[layer].height > 0 ? this->layers[layer].height : this->height;
+            }
+
+            // \brief Mark every layer as needing to be re-rendered
+            void invalidate_all() {
+                for (std::size_t i = 0; i < this->layers.size(); i++) {
+                    this->invalidate(i);
+                }
+            }
+
+            // \brief Get how many layers were re-rendered since the last call
+            std::size_t get_redraw_count() {
+                const std::size_t output = this->redraw_count;
+                this->redraw_count = 0;
+                return output;
+            }
+
+            /** Re-render every visible layer that was invalidated, then stack every visible layer onto the window (from the first added to the last) with one texture copy each
+             * \param window The window to render to
+             * \param render_layer A function that renders a layer (given its index) as if rendering straight to the window (or to a window of the layer's resolution, if it has one of its own); it starts out transparent (or cleared within the invalidated part)
+             */
+            template <class function_type> void render(bengine::render_window &window, const function_type &render_layer) {
+                // Every layer is re-rendered whenever the window is resized (textures that no longer match their layer's size are remade below)
+                if (window.get_width() != this->width || window.get_height() != this->height) {
+                    this->width = window.get_width();
+                    this->height = window.get_height();
+                    this->invalidate_all();
+                }
+                // Anything batched so far was meant for the window, not a layer
+                if (window.is_batching()) {
+                    window.flush_batches();
+                }
+
+                for (std::size_t i = 0; i < this->layers.size(); i++) {
+                    bengine::compositor::layer &current = this->layers[i];
+                    if (!current.visible || !current.dirty) {
+                        continue;
+                    }
+                    const int width = this->get_width(i), height = this->get_height(i);
+                    if (current.texture != nullptr && (current.texture_width != width || current.texture_height != height)) {
+                        SDL_DestroyTexture(current.texture);
+                        current.texture = nullptr;
+                    }
+                    if (current.texture == nullptr) {
+                        if ((current.texture = window.create_target_texture(width, height)) == NULL) {
+                            continue;
+                        }
+                        current.texture_width = width;
+                        current.texture_height = height;
+                    }
+                    // Layers with a resolution of their own are drawn in their own pixels, so they aren't stretched to the window
+                    window.target_renderer_at_texture(current.texture, current.width == 0);
+                    if (current.has_dirty_area) {
+                        window.clear_rectangle(current.dirty_area);
+                        window.set_clip_rectangle(current.dirty_area);
+                    } else {
+                        window.clear_renderer({0, 0, 0, 0});
+                    }
+                    render_layer(i);
+                    if (window.is_batching()) {
+                        window.flush_batches();
+                    }
+                    window.reset_clip_rectangle();
+                    window.target_renderer_at_window();
+                    current.dirty = false;
+                    current.has_dirty_area = false;
+                    this->redraw_count++;
+                }
+
+                const SDL_Rect dst = window.is_stretching_graphics() ? SDL_Rect{0, 0, window.get_base_width(), window.get_base_height()} : SDL_Rect{0, 0, this->width, this->height};
+                for (const bengine::compositor::layer &current : this->layers) {
+                    if (current.visible && current.texture != nullptr) {
+                        window.render_SDLTexture(current.texture, {0, 0, current.texture_width, current.texture_height}, dst);
+                    }
+                }
+            }
+    };
+}
+
+#endif // BENGINE_COMPOSITOR_hpp
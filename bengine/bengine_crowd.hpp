@@ -0,0 +1,440 @@
+#ifndef BENGINE_CROWD_hpp
+#define BENGINE_CROWD_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bengine_physics.hpp"
+#include "bengine_worker_pool.hpp"
+
+namespace bengine {
+    /** Steers a crowd of bodies in a bengine::physics_world_2d around each other using optimal reciprocal collision avoidance (ORCA)
+     *
+     * Every agent is given the velocity it would like to move at (e.g. from a bengine::flow_field_2d or a path), and each solve picks the closest velocity that won't run into any nearby agent within a time horizon, assuming the others do their half of the avoiding too
+     * Neighbors are found through a hashed grid rebuilt every solve, which is read-only while agents are solved so that they can be split across a bengine::worker_pool
+     * The chosen velocities are written to the bodies, leaving the world to move them (walls are still handled by the world's static colliders)
+     */
+    class crowd_2d {
+        private:
+            struct agent {
+                std::size_t body_id;
+                double radius;
+                double max_speed;
+                double preferred_x_vel, preferred_y_vel;
+                bool is_active;
+            };
+            struct vector {
+                double x, y;
+            };
+            // \brief A half-plane of allowed velocities (everything to the left of the line through point along direction)
+            struct line {
+                bengine::crowd_2d::vector point;
+                bengine::crowd_2d::vector direction;
+            };
+
+            static constexpr double epsilon = 1e-5;
+            // \brief Agents per task handed to the worker pool
+            static constexpr std::size_t chunk_size = 128;
+
+            std::vector<bengine::crowd_2d::agent> agents;
+            std::vector<std::size_t> free_ids;
+            bengine::worker_pool *workers = nullptr;
+
+            // \brief How far ahead (seconds) agents avoid each other; longer horizons start avoiding sooner but are more cautious
+            double time_horizon = 2;
+            // \brief How far away other agents are considered
+            double neighbor_distance = 3;
+            // \brief How many of the closest agents within neighbor_distance are considered
+            std::size_t max_neighbors = 10;
+
+            // \brief The IDs, positions, velocities, radii, max speeds, and preferred velocities of the active agents during a solve
+            std::vector<std::size_t> solve_ids;
+            std::vector<bengine::crowd_2d::vector> positions, velocities, preferred_velocities, new_velocities;
+            std::vector<double> radii, max_speeds;
+            // \brief The hashed grid of agents (cell_size is neighbor_distance, so every neighbor is in one of the 3x3 cells around an agent)
+            std::vector<std::uint32_t> bucket_starts, bucketed_agents, agent_buckets;
+
+            static double dot(const bengine::crowd_2d::vector &a, const bengine::crowd_2d::vector &b) {
+                return a.x * b.x + a.y * b.y;
+            }
+            static double det(const bengine::crowd_2d::vector &a, const bengine::crowd_2d::vector &b) {
+                return a.x * b.y - a.y * b.x;
+            }
+
+            std::uint32_t get_bucket(const long int &cell_x, const long int &cell_y) const {
+                const std::uint64_t key = static_cast<std::uint64_t>(cell_x) * 73856093u ^ static_cast<std::uint64_t>(cell_y) * 19349663u;
+                // The amount of buckets is a power of 2
+                return key & (this->bucket_starts.size() - 2);
+            }
+            // \brief Sort the agents into buckets of the hashed grid (a counting sort, so agents stay in index order within each bucket)
+            void build_grid() {
+                const std::size_t size = this->positions.size();
+                std::size_t bucket_count = 1;
+                while (bucket_count < size * 2) {
+                    bucket_count *= 2;
+                }
+                this->bucket_starts.assign(bucket_count + 1, 0);
+                this->agent_buckets.resize(size);
+                this->bucketed_agents.resize(size);
+                for (std::size_t i = 0; i < size; i++) {
+                    this->agent_buckets[i] = this->get_bucket(std::floor(this->positions[i].x / this->neighbor_distance), std::floor(this->positions[i].y / this->neighbor_distance));
+                    this->bucket_starts[this->agent_buckets[i] + 1]++;
+                }
+                for (std::size_t i = 0; i < bucket_count; i++) {
+                    this->bucket_starts[i + 1] += this->bucket_starts[i];
+                }
+                for (std::size_t i = 0; i < size; i++) {
+                    this->bucketed_agents[this->bucket_starts[this->agent_buckets[i]]++] = i;
+                }
+                // Filling the buckets moved each start to the next bucket's start, so they are shifted back
+                for (std::size_t i = bucket_count; i > 0; i--) {
+                    this->bucket_starts[i] = this->bucket_starts[i - 1];
+                }
+                this->bucket_starts[0] = 0;
+            }
+            /** Find the closest agents to an agent (within neighbor_distance)
+             * \param index The index of the agent
+             * \param output The output, sorted by distance squared (closest first)
+             */
+            void find_neighbors(const std::size_t &index, std::vector<std::pair<double, std::uint32_t>> &output) const {
+                output.clear();
+                if (this->max_neighbors == 0) {
+                    return;
+                }
+                const bengine::crowd_2d::vector &position = this->positions[index];
+                const long int cell_x = std::floor(position.x / this->neighbor_distance), cell_y = std::floor(position.y / this->neighbor_distance);
+                double range_squared = this->neighbor_distance * this->neighbor_distance;
+                // Different cells can hash to the same bucket, which must only be visited once
+                std::uint32_t visited[9];
+                std::size_t visited_count = 0;
+                for (long int y = cell_y - 1; y <= cell_y + 1; y++) {
+                    for (long int x = cell_x - 1; x <= cell_x + 1; x++) {
+                        const std::uint32_t bucket = this->get_bucket(x, y);
+                        if (std::find(visited, visited + visited_count, bucket) != visited + visited_count) {
+                            continue;
+                        }
+                        visited[visited_count++] = bucket;
+                        for (std::uint32_t i = this->bucket_starts[bucket]; i < this->bucket_starts[bucket + 1]; i++) {
+                            const std::uint32_t other = this->bucketed_agents[i];
+                            const double x_difference = this->positions[other].x - position.x, y_difference = this->positions[other].y - position.y;
+                            const double distance_squared = x_difference * x_difference + y_difference * y_difference;
+                            if (other == index || distance_squared >= range_squared) {
+                                continue;
+                            }
+                            // Insertion into a list that is kept at max_neighbors by dropping the furthest
+                            if (output.size() < this->max_neighbors) {
+                                output.emplace_back(distance_squared, other);
+                            } else {
+                                output.back() = std::make_pair(distance_squared, other);
+                            }
+                            for (std::size_t j = output.size() - 1; j > 0 && output[j] < output[j - 1]; j--) {
+                                std::swap(output[j], output[j - 1]);
+                            }
+                            if (output.size() == this->max_neighbors) {
+                                range_squared = output.back().first;
+                            }
+                        }
+                    }
+                }
+            }
+
+            /** Find the velocity on one line closest to the preferred velocity that also satisfies every earlier line and the speed limit
+             * \returns Whether there is such a velocity
+             */
+            static bool solve_on_line(const std::vector<bengine::crowd_2d::line> &lines, const std::size_t &line_index, const double &max_speed, const bengine::crowd_2d::vector &preferred, const bool &is_direction, bengine::crowd_2d::vector &result) {
+                const bengine::crowd_2d::line &current = lines[line_index];
+                const double dot_product = bengine::crowd_2d::dot(current.point, current.direction);
+                const double discriminant = dot_product * dot_product + max_speed * max_speed - bengine::crowd_2d::dot(current.point, current.point);
+                if (discriminant < 0) {
+                    // The speed limit doesn't reach the line
+                    return false;
+                }
+                double t_left = -dot_product - std::sqrt(discriminant), t_right = -dot_product + std::sqrt(discriminant);
+                for (std::size_t i = 0; i < line_index; i++) {
+                    const double denominator = bengine::crowd_2d::det(current.direction, lines[i].direction);
+                    const double numerator = bengine::crowd_2d::det(lines[i].direction, {current.point.x - lines[i].point.x, current.point.y - lines[i].point.y});
+                    if (std::fabs(denominator) <= bengine::crowd_2d::epsilon) {
+                        // The lines are parallel, so either all of this line is allowed by the other or none of it is
+                        if (numerator < 0) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    const double t = numerator / denominator;
+                    if (denominator >= 0) {
+                        t_right = std::min(t_right, t);
+                    } else {
+                        t_left = std::max(t_left, t);
+                    }
+                    if (t_left > t_right) {
+                        return false;
+                    }
+                }
+
+                double t;
+                if (is_direction) {
+                    t = bengine::crowd_2d::dot(preferred, current.direction) > 0 ? t_right : t_left;
+                } else {
+                    t = std::clamp(bengine::crowd_2d::dot(current.direction, {preferred.x - current.point.x, preferred.y - current.point.y}), t_left, t_right);
+                }
+                result = {current.point.x + t * current.direction.x, current.point.y + t * current.direction.y};
+                return true;
+            }
+            /** Find the velocity closest to the preferred one (or furthest in a direction) that satisfies every line and the speed limit
+             * \returns The amount of lines, or the index of the first line that couldn't be satisfied (result is then the best velocity found before it)
+             */
+            static std::size_t solve_lines(const std::vector<bengine::crowd_2d::line> &lines, const double &max_speed, const bengine::crowd_2d::vector &preferred, const bool &is_direction, bengine::crowd_2d::vector &result) {
+                const double preferred_speed_squared = bengine::crowd_2d::dot(preferred, preferred);
+                if (is_direction) {
+                    result = {preferred.x * max_speed, preferred.y * max_speed};
+                } else if (preferred_speed_squared > max_speed * max_speed) {
+                    const double scale = max_speed / std::sqrt(preferred_speed_squared);
+                    result = {preferred.x * scale, preferred.y * scale};
+                } else {
+                    result = preferred;
+                }
+                for (std::size_t i = 0; i < lines.size(); i++) {
+                    if (bengine::crowd_2d::det(lines[i].direction, {lines[i].point.x - result.x, lines[i].point.y - result.y}) > 0) {
+                        const bengine::crowd_2d::vector previous = result;
+                        if (!bengine::crowd_2d::solve_on_line(lines, i, max_speed, preferred, is_direction, result)) {
+                            result = previous;
+                            return i;
+                        }
+                    }
+                }
+                return lines.size();
+            }
+            /** Find the velocity that breaks the lines (from first_failed onwards) by the least, for when agents are packed too tightly to satisfy them all
+             * \param projected_lines Scratch space
+             */
+            static void solve_crowded(const std::vector<bengine::crowd_2d::line> &lines, const std::size_t &first_failed, const double &max_speed, bengine::crowd_2d::vector &result, std::vector<bengine::crowd_2d::line> &projected_lines) {
+                double distance = 0;
+                for (std::size_t i = first_failed; i < lines.size(); i++) {
+                    if (bengine::crowd_2d::det(lines[i].direction, {lines[i].point.x - result.x, lines[i].point.y - result.y}) <= distance) {
+                        continue;
+                    }
+                    // The result breaks this line by more than any before it, so the lines before it are projected onto it
+                    projected_lines.clear();
+                    for (std::size_t j = 0; j < i; j++) {
+                        bengine::crowd_2d::line projected;
+                        const double determinant = bengine::crowd_2d::det(lines[i].direction, lines[j].direction);
+                        if (std::fabs(determinant) <= bengine::crowd_2d::epsilon) {
+                            if (bengine::crowd_2d::dot(lines[i].direction, lines[j].direction) > 0) {
+                                continue;
+                            }
+                            projected.point = {(lines[i].point.x + lines[j].point.x) / 2, (lines[i].point.y + lines[j].point.y) / 2};
+                        } else {
+                            const double t = bengine::crowd_2d::det(lines[j].direction, {lines[i].point.x - lines[j].point.x, lines[i].point.y - lines[j].point.y}) / determinant;
+                            projected.point = {lines[i].point.x + t * lines[i].direction.x, lines[i].point.y + t * lines[i].direction.y};
+                        }
+                        const double x_direction = lines[j].direction.x - lines[i].direction.x, y_direction = lines[j].direction.y - lines[i].direction.y;
+                        const double length = std::sqrt(x_direction * x_direction + y_direction * y_direction);
+                        projected.direction = {x_direction / length, y_direction / length};
+                        projected_lines.emplace_back(projected);
+                    }
+                    const bengine::crowd_2d::vector previous = result;
+                    if (bengine::crowd_2d::solve_lines(projected_lines, max_speed, {-lines[i].direction.y, lines[i].direction.x}, true, result) < projected_lines.size()) {
+                        // Can only fail because of rounding, in which case the previous result is as good as it gets
+                        result = previous;
+                    }
+                    distance = bengine::crowd_2d::det(lines[i].direction, {lines[i].point.x - result.x, lines[i].point.y - result.y});
+                }
+            }
+            /** Pick a new velocity for an agent
+             * \param index The index of the agent
+             * \param delta_time How long the coming step is (agents already overlapping try to separate within it)
+             * \param neighbors Scratch space
+             * \param lines Scratch space
+             * \param projected_lines Scratch space
+             */
+            void solve_agent(const std::size_t &index, const double &delta_time, std::vector<std::pair<double, std::uint32_t>> &neighbors, std::vector<bengine::crowd_2d::line> &lines, std::vector<bengine::crowd_2d::line> &projected_lines) {
+                this->find_neighbors(index, neighbors);
+                lines.clear();
+                const bengine::crowd_2d::vector &position = this->positions[index], &velocity = this->velocities[index];
+                const double inverse_horizon = 1 / this->time_horizon;
+                for (const std::pair<double, std::uint32_t> &neighbor : neighbors) {
+                    const std::uint32_t other = neighbor.second;
+                    const bengine::crowd_2d::vector relative_position = {this->positions[other].x - position.x, this->positions[other].y - position.y};
+                    const bengine::crowd_2d::vector relative_velocity = {velocity.x - this->velocities[other].x, velocity.y - this->velocities[other].y};
+                    const double distance_squared = neighbor.first;
+                    const double combined_radius = this->radii[index] + this->radii[other];
+                    const double combined_radius_squared = combined_radius * combined_radius;
+
+                    bengine::crowd_2d::line line;
+                    bengine::crowd_2d::vector u;
+                    if (distance_squared > combined_radius_squared) {
+                        // The smallest change to the relative velocity that gets it out of the velocity obstacle (a truncated cone)
+                        const bengine::crowd_2d::vector w = {relative_velocity.x - inverse_horizon * relative_position.x, relative_velocity.y - inverse_horizon * relative_position.y};
+                        const double w_length_squared = bengine::crowd_2d::dot(w, w);
+                        const double dot_product = bengine::crowd_2d::dot(w, relative_position);
+                        if (dot_product < 0 && dot_product * dot_product > combined_radius_squared * w_length_squared) {
+                            // Closest to the rounded cap of the cone
+                            const double w_length = std::sqrt(w_length_squared);
+                            const bengine::crowd_2d::vector unit_w = {w.x / w_length, w.y / w_length};
+                            line.direction = {unit_w.y, -unit_w.x};
+                            u = {(combined_radius * inverse_horizon - w_length) * unit_w.x, (combined_radius * inverse_horizon - w_length) * unit_w.y};
+                        } else {
+                            // Closest to one of the sides of the cone
+                            const double leg = std::sqrt(distance_squared - combined_radius_squared);
+                            if (bengine::crowd_2d::det(relative_position, w) > 0) {
+                                line.direction = {(relative_position.x * leg - relative_position.y * combined_radius) / distance_squared, (relative_position.x * combined_radius + relative_position.y * leg) / distance_squared};
+                            } else {
+                                line.direction = {-(relative_position.x * leg + relative_position.y * combined_radius) / distance_squared, -(-relative_position.x * combined_radius + relative_position.y * leg) / distance_squared};
+                            }
+                            const double projection = bengine::crowd_2d::dot(relative_velocity, line.direction);
+                            u = {projection * line.direction.x - relative_velocity.x, projection * line.direction.y - relative_velocity.y};
+                        }
+                    } else {
+                        // Already overlapping, so the agents separate within the coming step
+                        const double inverse_step = 1 / delta_time;
+                        const bengine::crowd_2d::vector w = {relative_velocity.x - inverse_step * relative_position.x, relative_velocity.y - inverse_step * relative_position.y};
+                        const double w_length = std::sqrt(bengine::crowd_2d::dot(w, w));
+                        const bengine::crowd_2d::vector unit_w = w_length > 0 ? bengine::crowd_2d::vector{w.x / w_length, w.y / w_length} : bengine::crowd_2d::vector{1, 0};
+                        line.direction = {unit_w.y, -unit_w.x};
+                        u = {(combined_radius * inverse_step - w_length) * unit_w.x, (combined_radius * inverse_step - w_length) * unit_w.y};
+                    }
+                    // Each agent takes half of the responsibility for avoiding the other
+                    line.point = {velocity.x + u.x / 2, velocity.y + u.y / 2};
+                    lines.emplace_back(line);
+                }
+
+                bengine::crowd_2d::vector &result = this->new_velocities[index];
+                const std::size_t first_failed = bengine::crowd_2d::solve_lines(lines, this->max_speeds[index], this->preferred_velocities[index], false, result);
+                if (first_failed < lines.size()) {
+                    bengine::crowd_2d::solve_crowded(lines, first_failed, this->max_speeds[index], result, projected_lines);
+                }
+            }
+
+        public:
+            crowd_2d() {}
+
+            /** Set the threads used to solve agents; results are the same no matter how many threads there are
+             * \param workers The threads to use, or nullptr to solve everything on the calling thread
+             */
+            void set_worker_pool(bengine::worker_pool *workers) {
+                this->workers = workers;
+            }
+            double get_time_horizon() const {
+                return this->time_horizon;
+            }
+            void set_time_horizon(const double &time_horizon) {
+                this->time_horizon = std::max(time_horizon, bengine::crowd_2d::epsilon);
+            }
+            double get_neighbor_distance() const {
+                return this->neighbor_distance;
+            }
+            void set_neighbor_distance(const double &neighbor_distance) {
+                this->neighbor_distance = std::max(neighbor_distance, bengine::crowd_2d::epsilon);
+            }
+            std::size_t get_max_neighbors() const {
+                return this->max_neighbors;
+            }
+            void set_max_neighbors(const std::size_t &max_neighbors) {
+                this->max_neighbors = max_neighbors;
+            }
+
+            /** Add an agent
+             * \param body_id The ID of the agent's body in the world passed to bengine::crowd_2d::solve
+             * \param radius The radius of the agent (e.g. half the diagonal of its collider)
+             * \param max_speed The fastest the agent can move
+             * \returns The ID that the agent can be referred to with from now on
+             */
+            std::size_t add_agent(const std::size_t &body_id, const double &radius, const double &max_speed) {
+                std::size_t id;
+                if (this->free_ids.empty()) {
+                    id = this->agents.size();
+                    this->agents.emplace_back();
+                } else {
+                    id = this->free_ids.back();
+                    this->free_ids.pop_back();
+                }
+                this->agents[id] = {body_id, radius, max_speed, 0, 0, true};
+                return id;
+            }
+            /** Remove an agent (its ID may be handed out again by a later addition)
+             * \param id The ID of the agent
+             */
+            void remove_agent(const std::size_t &id) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                this->agents[id].is_active = false;
+                this->free_ids.emplace_back(id);
+            }
+            bool contains(const std::size_t &id) const {
+                return id < this->agents.size() && this->agents[id].is_active;
+            }
+            /** Set the velocity an agent would move at if nothing was in its way
+             * \param id The ID of the agent
+             * \param x_vel The preferred x-velocity
+             * \param y_vel The preferred y-velocity
+             */
+            void set_preferred_velocity(const std::size_t &id, const double &x_vel, const double &y_vel) {
+                if (this->contains(id)) {
+                    this->agents[id].preferred_x_vel = x_vel;
+                    this->agents[id].preferred_y_vel = y_vel;
+                }
+            }
+            void set_max_speed(const std::size_t &id, const double &max_speed) {
+                if (this->contains(id)) {
+                    this->agents[id].max_speed = max_speed;
+                }
+            }
+
+            /** Pick a new velocity for every agent and set it on the agent's body (call before bengine::physics_world_2d::step)
+             * \param world The world that the agents' bodies are in (agents whose bodies have been removed are skipped)
+             * \param delta_time How long the coming step is
+             */
+            void solve(bengine::physics_world_2d &world, const double &delta_time) {
+                this->solve_ids.clear();
+                this->positions.clear();
+                this->velocities.clear();
+                this->preferred_velocities.clear();
+                this->radii.clear();
+                this->max_speeds.clear();
+                for (std::size_t id = 0; id < this->agents.size(); id++) {
+                    const bengine::crowd_2d::agent &agent = this->agents[id];
+                    if (!agent.is_active || !world.contains(agent.body_id)) {
+                        continue;
+                    }
+                    this->solve_ids.emplace_back(id);
+                    this->positions.push_back({world.get_x_pos(agent.body_id), world.get_y_pos(agent.body_id)});
+                    this->velocities.push_back({world.get_x_vel(agent.body_id), world.get_y_vel(agent.body_id)});
+                    this->preferred_velocities.push_back({agent.preferred_x_vel, agent.preferred_y_vel});
+                    this->radii.emplace_back(agent.radius);
+                    this->max_speeds.emplace_back(agent.max_speed);
+                }
+                const std::size_t size = this->solve_ids.size();
+                if (size == 0 || delta_time <= 0) {
+                    return;
+                }
+                this->new_velocities.resize(size);
+                this->build_grid();
+
+                // Agents only read the positions/velocities gathered above and write their own new velocity, so they can be solved in any order
+                const auto solve_range = [&](const std::size_t &begin, const std::size_t &end) {
+                    std::vector<std::pair<double, std::uint32_t>> neighbors;
+                    std::vector<bengine::crowd_2d::line> lines, projected_lines;
+                    neighbors.reserve(this->max_neighbors);
+                    lines.reserve(this->max_neighbors);
+                    projected_lines.reserve(this->max_neighbors);
+                    for (std::size_t i = begin; i < end; i++) {
+                        this->solve_agent(i, delta_time, neighbors, lines, projected_lines);
+                    }
+                };
+                if (this->workers == nullptr) {
+                    solve_range(0, size);
+                } else {
+                    this->workers->run_chunked(size, bengine::crowd_2d::chunk_size, solve_range);
+                }
+
+                for (std::size_t i = 0; i < size; i++) {
+                    world.set_velocity(this->agents[this->solve_ids[i]].body_id, this->new_velocities[i].x, this->new_velocities[i].y);
+                }
+            }
+    };
+}
+
+#endif // BENGINE_CROWD_hpp
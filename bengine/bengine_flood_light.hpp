@@ -0,0 +1,245 @@
+#ifndef BENGINE_FLOOD_LIGHT_hpp
+#define BENGINE_FLOOD_LIGHT_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bengine_grid.hpp"
+
+namespace bengine {
+    /** Light spread through the empty cells of a bengine::grid_2d with a flood fill, losing one level per cell travelled (much cheaper than bengine::lighting_2d, but blockier)
+     *
+     * Every cell stores the brightest level reaching it, so looking up light is a single read; adding/removing a source or editing a wall only floods the cells that the change can reach
+     */
+    class flood_light_2d {
+        private:
+            // \brief The grid the light spreads through (must outlive the flood light)
+            const bengine::grid_2d *grid = nullptr;
+            std::size_t cols = 0;
+            std::size_t rows = 0;
+            // \brief The level at which light is fully bright (also the furthest in cells that light can spread)
+            std::uint8_t max_level;
+            // \brief The light level of every cell
+            std::vector<std::uint8_t> levels;
+            // \brief The level of the source in every cell (0 if there is no source)
+            std::vector<std::uint8_t> source_levels;
+
+            // \brief Cells that light spreads outwards from (used as a FIFO, with the index of the next cell kept separately)
+            std::vector<std::size_t> spread_queue;
+            // \brief Cells whose light has been taken away, along with the level they had
+            std::vector<std::pair<std::size_t, std::uint8_t>> removal_queue;
+            // \brief How many cells changed level since the last call to bengine::flood_light_2d::get_changed_count
+            std::size_t changed_count = 0;
+
+            bool is_open(const std::size_t &cell) const {
+                return !this->grid->is_solid(cell % this->cols, cell / this->cols);
+            }
+            /** Call a function with every in-bounds neighbor (up/down/left/right) of a cell
+             * \param cell The index of the cell
+             * \param function The function to call with the index of each neighbor
+             */
+            template <typename F> void for_each_neighbor(const std::size_t &cell, const F &function) const {
+                const std::size_t col = cell % this->cols, row = cell / this->cols;
+                if (col > 0) {
+                    function(cell - 1);
+                }
+                if (col + 1 < this->cols) {
+                    function(cell + 1);
+                }
+                if (row > 0) {
+                    function(cell - this->cols);
+                }
+                if (row + 1 < this->rows) {
+                    function(cell + this->cols);
+                }
+            }
+            void set_level(const std::size_t &cell, const std::uint8_t &level) {
+                if (this->levels[cell] != level) {
+                    this->levels[cell] = level;
+                    this->changed_count++;
+                }
+            }
+
+            // \brief Spread light outwards from every cell in the spread queue, until it either fades or meets brighter light
+            void spread() {
+                for (std::size_t head = 0; head < this->spread_queue.size(); head++) {
+                    const std::size_t cell = this->spread_queue[head];
+                    const std::uint8_t level = this->levels[cell];
+                    if (level <= 1) {
+                        continue;
+                    }
+                    this->for_each_neighbor(cell, [&](const std::size_t &neighbor) {
+                        if (this->levels[neighbor] + 1 < level && this->is_open(neighbor)) {
+                            this->set_level(neighbor, level - 1);
+                            this->spread_queue.emplace_back(neighbor);
+                        }
+                    });
+                }
+                this->spread_queue.clear();
+            }
+            /** Take away all light that came from the cells in the removal queue, queueing up any brighter light bordering the darkened area to spread back into it
+             *
+             * A neighbor dimmer than the removed light must have been lit by it (so it is darkened too), while one at least as bright has its own path to a source
+             */
+            void remove() {
+                for (std::size_t head = 0; head < this->removal_queue.size(); head++) {
+                    const std::size_t cell = this->removal_queue[head].first;
+                    const std::uint8_t level = this->removal_queue[head].second;
+                    this->for_each_neighbor(cell, [&](const std::size_t &neighbor) {
+                        const std::uint8_t neighbor_level = this->levels[neighbor];
+                        if (neighbor_level != 0 && neighbor_level < level) {
+                            this->set_level(neighbor, 0);
+                            this->removal_queue.emplace_back(neighbor, neighbor_level);
+                        } else if (neighbor_level >= level) {
+                            this->spread_queue.emplace_back(neighbor);
+                        }
+                    });
+                }
+                // Sources inside the darkened area relight it
+                for (const std::pair<std::size_t, std::uint8_t> &removal : this->removal_queue) {
+                    if (this->source_levels[removal.first] > this->levels[removal.first] && this->is_open(removal.first)) {
+                        this->set_level(removal.first, this->source_levels[removal.first]);
+                        this->spread_queue.emplace_back(removal.first);
+                    }
+                }
+                this->removal_queue.clear();
+            }
+            // \brief Darken a cell and everything it lit, then let the remaining light spread back in
+            void darken(const std::size_t &cell) {
+                const std::uint8_t level = this->levels[cell];
+                if (level == 0) {
+                    return;
+                }
+                this->set_level(cell, 0);
+                this->removal_queue.emplace_back(cell, level);
+                this->remove();
+                this->spread();
+            }
+
+        public:
+            /** Create a flood light
+             * \param max_level The level at which light is fully bright, which is also how many cells light at that level spreads (at most 255)
+             */
+            flood_light_2d(const std::uint8_t &max_level = 15) {
+                this->max_level = std::max<std::uint8_t>(max_level, 1);
+            }
+
+            /** Set the grid that light spreads through, removing every source (needed before any sources can be added, and again if the grid is resized)
+             * \param grid The grid (must outlive the flood light)
+             */
+            void load(const bengine::grid_2d &grid) {
+                this->grid = &grid;
+                this->cols = grid.get_cols();
+                this->rows = grid.get_rows();
+                this->levels.assign(this->cols * this->rows, 0);
+                this->source_levels.assign(this->cols * this->rows, 0);
+                this->changed_count = 0;
+            }
+            /** Update the light around a cell after it has been edited; walls block light (and have none of their own), so light is either removed from the cell or spread back into it
+             * \param col The column of the edited cell
+             * \param row The row of the edited cell
+             */
+            void refresh_cell(const std::size_t &col, const std::size_t &row) {
+                if (col >= this->cols || row >= this->rows) {
+                    return;
+                }
+                const std::size_t cell = row * this->cols + col;
+                if (!this->is_open(cell)) {
+                    this->darken(cell);
+                    return;
+                }
+                this->set_level(cell, std::max(this->levels[cell], this->source_levels[cell]));
+                this->spread_queue.emplace_back(cell);
+                this->for_each_neighbor(cell, [&](const std::size_t &neighbor) {
+                    if (this->levels[neighbor] > 1) {
+                        this->spread_queue.emplace_back(neighbor);
+                    }
+                });
+                this->spread();
+            }
+
+            std::uint8_t get_max_level() const {
+                return this->max_level;
+            }
+
+            /** Add a source of light to a cell, replacing any source already there (sources in walls give off no light until the wall is removed)
+             * \param col The column of the cell
+             * \param row The row of the cell
+             * \param level How bright the source is (clamped to the max level)
+             */
+            void add_source(const std::size_t &col, const std::size_t &row, const std::uint8_t &level) {
+                if (col >= this->cols || row >= this->rows) {
+                    return;
+                }
+                const std::size_t cell = row * this->cols + col;
+                const std::uint8_t clamped_level = std::min(level, this->max_level);
+                if (clamped_level < this->source_levels[cell]) {
+                    // A dimmer replacement has to take the old source's light away first
+                    this->remove_source(col, row);
+                }
+                this->source_levels[cell] = clamped_level;
+                if (this->is_open(cell) && clamped_level > this->levels[cell]) {
+                    this->set_level(cell, clamped_level);
+                    this->spread_queue.emplace_back(cell);
+                    this->spread();
+                }
+            }
+            /** Remove the source of light in a cell (if there is one)
+             * \param col The column of the cell
+             * \param row The row of the cell
+             */
+            void remove_source(const std::size_t &col, const std::size_t &row) {
+                if (col >= this->cols || row >= this->rows || this->source_levels[row * this->cols + col] == 0) {
+                    return;
+                }
+                const std::size_t cell = row * this->cols + col;
+                this->source_levels[cell] = 0;
+                this->darken(cell);
+            }
+            // \brief Get the level of the source in a cell (0 if there is none)
+            std::uint8_t get_source_level(const std::size_t &col, const std::size_t &row) const {
+                return col < this->cols && row < this->rows ? this->source_levels[row * this->cols + col] : 0;
+            }
+
+            // \brief Get the light level of a cell (0 for walls and cells out of bounds)
+            std::uint8_t get_level(const std::size_t &col, const std::size_t &row) const {
+                return col < this->cols && row < this->rows ? this->levels[row * this->cols + col] : 0;
+            }
+            /** Get how brightly lit a point is
+             * \param x_pos The x-position of the point
+             * \param y_pos The y-position of the point
+             * \returns The light level of the cell containing the point (0-1)
+             */
+            double get_light_level(const double &x_pos, const double &y_pos) const {
+                if (x_pos < 0 || y_pos < 0) {
+                    return 0;
+                }
+                return static_cast<double>(this->get_level(x_pos, y_pos)) / this->max_level;
+            }
+            /** Get how brightly lit the face of a wall that a ray hit is (from the light in the cell in front of it)
+             * \param hit The hit
+             * \param angle The direction of the ray that hit the face (radians)
+             * \returns The light level (0-1)
+             */
+            double get_face_light_level(const bengine::grid_2d::ray_hit &hit, const double &angle) const {
+                std::size_t col = hit.col, row = hit.row;
+                if (hit.vertical_face) {
+                    col += std::cos(angle) > 0 ? -1 : 1;
+                } else {
+                    row += std::sin(angle) > 0 ? -1 : 1;
+                }
+                return static_cast<double>(this->get_level(col, row)) / this->max_level;
+            }
+
+            // \brief Get how many cells changed level since the last call (useful for knowing whether anything needs to be redrawn)
+            std::size_t get_changed_count() {
+                const std::size_t output = this->changed_count;
+                this->changed_count = 0;
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_FLOOD_LIGHT_hpp
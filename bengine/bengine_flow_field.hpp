@@ -0,0 +1,350 @@
+#ifndef BENGINE_FLOW_FIELD_hpp
+#define BENGINE_FLOW_FIELD_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bengine_grid.hpp"
+#include "bengine_worker_pool.hpp"
+
+namespace bengine {
+    /** Guides any number of agents towards a shared goal (e.g. the player) through the empty cells of a bengine::grid_2d
+     *
+     * An integration field (the distance from every cell to the goal) is built by a wavefront spreading out from the goal, with each front split across a bengine::worker_pool if one is set
+     * Every cell then points towards its closest neighbor, so each agent only has to look up the cell it is in
+     * The field is double-buffered: when the goal changes cell, the new field is built (all at once, or a few fronts per call to update) while agents keep following the old one
+     * A new goal always rebuilds the whole field from scratch; spreading it over several calls to update only splits that cost across ticks, it doesn't make it any smaller
+     */
+    class flow_field_2d {
+        public:
+            // \brief The distance of cells that can't reach the goal
+            static constexpr std::uint32_t unreachable = UINT32_MAX;
+            // \brief The cost of a straight step (a diagonal step costs 3, which is close to 2 * sqrt(2) while keeping distances whole)
+            static constexpr std::uint32_t straight_cost = 2;
+            static constexpr std::uint32_t diagonal_cost = 3;
+
+        private:
+            // \brief The amount of fronts that can have cells waiting at once (a cell only adds cells up to diagonal_cost further away)
+            static constexpr std::size_t ring_size = bengine::flow_field_2d::diagonal_cost + 1;
+            // \brief The value of a cell's direction when it has nowhere to go (walls, the goal, and cells that can't reach the goal)
+            static constexpr std::uint8_t no_direction = 8;
+            // \brief Cells per task handed to the worker pool (fronts no bigger than this are spread on the calling thread)
+            static constexpr std::size_t chunk_size = 512;
+
+            const bengine::grid_2d *grid = nullptr;
+            bengine::worker_pool *workers = nullptr;
+            long int cols = 0;
+            long int rows = 0;
+            // \brief Which of the 8 directions each cell can step in (one bit per direction), so that spreading never has to look at the grid
+            std::vector<std::uint8_t> step_masks;
+
+            // \brief The field that agents follow
+            std::vector<std::uint32_t> distances;
+            std::vector<std::uint8_t> directions;
+            long int goal_col = -1, goal_row = -1;
+            bool is_field_ready = false;
+
+            // \brief The field being built (atomic since cells in the same front can lower the same neighbor at once)
+            std::vector<std::atomic<std::uint32_t>> building_distances;
+            long int building_goal_col = -1, building_goal_row = -1;
+            bool is_field_building = false;
+            // \brief Cells waiting to spread, in a ring indexed by distance
+            std::vector<std::uint32_t> fronts[bengine::flow_field_2d::ring_size];
+            // \brief The distance of the next front to spread
+            std::uint32_t front_distance = 0;
+            // \brief Cells added to later fronts by each chunk of the current front, which are merged into the ring once the whole front has spread
+            std::vector<std::vector<std::uint32_t>> chunk_outputs[bengine::flow_field_2d::ring_size];
+
+            static long int get_col_offset(const std::uint8_t &direction) {
+                static constexpr long int offsets[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+                return offsets[direction];
+            }
+            static long int get_row_offset(const std::uint8_t &direction) {
+                static constexpr long int offsets[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+                return offsets[direction];
+            }
+
+            bool is_open(const long int &col, const long int &row) const {
+                return this->grid->is_in_bounds(col, row) && !this->grid->is_solid(col, row);
+            }
+            /** Work out which of the 8 directions a cell can step in (straight ones come first, and diagonal steps can't cut the corners of walls)
+             * \param col The column of the cell
+             * \param row The row of the cell
+             */
+            std::uint8_t get_step_mask(const long int &col, const long int &row) const {
+                if (!this->is_open(col, row)) {
+                    return 0;
+                }
+                std::uint8_t output = 0;
+                for (std::uint8_t direction = 0; direction < 8; direction++) {
+                    const long int next_col = col + bengine::flow_field_2d::get_col_offset(direction), next_row = row + bengine::flow_field_2d::get_row_offset(direction);
+                    if (this->is_open(next_col, next_row) && (direction < 4 || (this->is_open(next_col, row) && this->is_open(col, next_row)))) {
+                        output |= 1 << direction;
+                    }
+                }
+                return output;
+            }
+            bool can_step(const std::uint32_t &cell, const std::uint8_t &direction) const {
+                return (this->step_masks[cell] >> direction) & 1;
+            }
+
+            /** Spread cells of the current front into their neighbors
+             * \param cells The cells to spread
+             * \param count The amount of cells
+             * \param outputs Where neighbors that got closer are added to (one vector per slot of the ring)
+             */
+            void spread_cells(const std::uint32_t *cells, const std::size_t &count, std::vector<std::uint32_t> *const *outputs) {
+                for (std::size_t i = 0; i < count; i++) {
+                    const std::uint32_t cell = cells[i];
+                    // Cells that got closer after being added to this front were already spread from a closer front
+                    if (this->building_distances[cell].load(std::memory_order_relaxed) != this->front_distance) {
+                        continue;
+                    }
+                    for (std::uint8_t direction = 0; direction < 8; direction++) {
+                        if (!this->can_step(cell, direction)) {
+                            continue;
+                        }
+                        const std::uint32_t neighbor = cell + bengine::flow_field_2d::get_row_offset(direction) * this->cols + bengine::flow_field_2d::get_col_offset(direction);
+                        const std::uint32_t distance = this->front_distance + (direction < 4 ? bengine::flow_field_2d::straight_cost : bengine::flow_field_2d::diagonal_cost);
+                        std::uint32_t current = this->building_distances[neighbor].load(std::memory_order_relaxed);
+                        while (distance < current) {
+                            if (this->building_distances[neighbor].compare_exchange_weak(current, distance, std::memory_order_relaxed)) {
+                                outputs[distance % bengine::flow_field_2d::ring_size]->emplace_back(neighbor);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            // \brief Spread the next front of the field being built (the front's own slot in the ring is never written to while it spreads, since nothing is 0 further away)
+            void spread_front() {
+                std::vector<std::uint32_t> &front = this->fronts[this->front_distance % bengine::flow_field_2d::ring_size];
+                const std::size_t count = front.size();
+                if (this->workers == nullptr || count <= bengine::flow_field_2d::chunk_size) {
+                    std::vector<std::uint32_t> *outputs[bengine::flow_field_2d::ring_size];
+                    for (std::size_t i = 0; i < bengine::flow_field_2d::ring_size; i++) {
+                        outputs[i] = &this->fronts[i];
+                    }
+                    this->spread_cells(front.data(), count, outputs);
+                } else {
+                    const std::size_t chunk_count = (count + bengine::flow_field_2d::chunk_size - 1) / bengine::flow_field_2d::chunk_size;
+                    for (std::size_t i = 0; i < bengine::flow_field_2d::ring_size; i++) {
+                        if (this->chunk_outputs[i].size() < chunk_count) {
+                            this->chunk_outputs[i].resize(chunk_count);
+                        }
+                    }
+                    this->workers->run_chunked(count, bengine::flow_field_2d::chunk_size, [&](const std::size_t &begin, const std::size_t &end) {
+                        std::vector<std::uint32_t> *outputs[bengine::flow_field_2d::ring_size];
+                        for (std::size_t i = 0; i < bengine::flow_field_2d::ring_size; i++) {
+                            outputs[i] = &this->chunk_outputs[i][begin / bengine::flow_field_2d::chunk_size];
+                        }
+                        this->spread_cells(front.data() + begin, end - begin, outputs);
+                    });
+                    // Which thread claims a cell first (and so the order of cells within a front) depends on timing, but every cell still ends up with its shortest distance, so the finished field is the same no matter how many threads there are
+                    for (std::size_t i = 0; i < bengine::flow_field_2d::ring_size; i++) {
+                        for (std::size_t chunk = 0; chunk < chunk_count; chunk++) {
+                            this->fronts[i].insert(this->fronts[i].end(), this->chunk_outputs[i][chunk].begin(), this->chunk_outputs[i][chunk].end());
+                            this->chunk_outputs[i][chunk].clear();
+                        }
+                    }
+                }
+                front.clear();
+                this->front_distance++;
+            }
+            bool has_waiting_cells() const {
+                for (std::size_t i = 0; i < bengine::flow_field_2d::ring_size; i++) {
+                    if (!this->fronts[i].empty()) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            // \brief Point every cell of the finished field towards its closest neighbor, then swap it in for agents to follow
+            void finish_field() {
+                const std::size_t size = this->cols * this->rows;
+                this->distances.resize(size);
+                this->directions.resize(size);
+                const auto point_cells = [&](const std::size_t &begin, const std::size_t &end) {
+                    for (std::size_t cell = begin; cell < end; cell++) {
+                        this->distances[cell] = this->building_distances[cell].load(std::memory_order_relaxed);
+                    }
+                    for (std::size_t cell = begin; cell < end; cell++) {
+                        std::uint8_t best_direction = bengine::flow_field_2d::no_direction;
+                        std::uint32_t best_distance = this->building_distances[cell].load(std::memory_order_relaxed);
+                        if (best_distance != bengine::flow_field_2d::unreachable) {
+                            for (std::uint8_t direction = 0; direction < 8; direction++) {
+                                if (!this->can_step(cell, direction)) {
+                                    continue;
+                                }
+                                const std::uint32_t distance = this->building_distances[cell + bengine::flow_field_2d::get_row_offset(direction) * this->cols + bengine::flow_field_2d::get_col_offset(direction)].load(std::memory_order_relaxed);
+                                if (distance < best_distance) {
+                                    best_distance = distance;
+                                    best_direction = direction;
+                                }
+                            }
+                        }
+                        this->directions[cell] = best_direction;
+                    }
+                };
+                if (this->workers == nullptr) {
+                    point_cells(0, size);
+                } else {
+                    this->workers->run_chunked(size, bengine::flow_field_2d::chunk_size * 8, point_cells);
+                }
+                this->goal_col = this->building_goal_col;
+                this->goal_row = this->building_goal_row;
+                this->is_field_ready = true;
+                this->is_field_building = false;
+            }
+            // \brief Start building a field towards a goal cell
+            void start_field(const long int &col, const long int &row) {
+                const std::size_t size = this->cols * this->rows;
+                if (this->building_distances.size() != size) {
+                    this->building_distances = std::vector<std::atomic<std::uint32_t>>(size);
+                }
+                for (std::atomic<std::uint32_t> &distance : this->building_distances) {
+                    distance.store(bengine::flow_field_2d::unreachable, std::memory_order_relaxed);
+                }
+                for (std::size_t i = 0; i < bengine::flow_field_2d::ring_size; i++) {
+                    this->fronts[i].clear();
+                }
+                this->building_goal_col = col;
+                this->building_goal_row = row;
+                this->front_distance = 0;
+                this->is_field_building = true;
+                if (this->is_open(col, row)) {
+                    this->building_distances[row * this->cols + col].store(0, std::memory_order_relaxed);
+                    this->fronts[0].emplace_back(row * this->cols + col);
+                }
+            }
+
+        public:
+            flow_field_2d() {}
+
+            /** Set the grid that agents move through, throwing away the current field (needed before a goal can be set, and again if the grid is resized)
+             * \param grid The grid (must outlive the flow field)
+             */
+            void load(const bengine::grid_2d &grid) {
+                this->grid = &grid;
+                this->cols = grid.get_cols();
+                this->rows = grid.get_rows();
+                this->step_masks.resize(this->cols * this->rows);
+                for (long int row = 0; row < this->rows; row++) {
+                    for (long int col = 0; col < this->cols; col++) {
+                        this->step_masks[row * this->cols + col] = this->get_step_mask(col, row);
+                    }
+                }
+                this->is_field_ready = false;
+                this->is_field_building = false;
+                this->goal_col = this->goal_row = this->building_goal_col = this->building_goal_row = -1;
+            }
+            /** Set the threads used to build fields; fields are the same no matter how many threads there are
+             * \param workers The threads to use, or nullptr to build on the calling thread
+             */
+            void set_worker_pool(bengine::worker_pool *workers) {
+                this->workers = workers;
+            }
+            /** Update a cell after it has been edited, and rebuild the field (the old field is followed until the new one is finished)
+             * \param col The column of the edited cell
+             * \param row The row of the edited cell
+             */
+            void refresh_cell(const std::size_t &col, const std::size_t &row) {
+                for (long int row_offset = -1; row_offset <= 1; row_offset++) {
+                    for (long int col_offset = -1; col_offset <= 1; col_offset++) {
+                        const long int neighbor_col = col + col_offset, neighbor_row = row + row_offset;
+                        if (neighbor_col >= 0 && neighbor_row >= 0 && neighbor_col < this->cols && neighbor_row < this->rows) {
+                            this->step_masks[neighbor_row * this->cols + neighbor_col] = this->get_step_mask(neighbor_col, neighbor_row);
+                        }
+                    }
+                }
+                const long int goal_col = this->is_field_building ? this->building_goal_col : this->goal_col, goal_row = this->is_field_building ? this->building_goal_row : this->goal_row;
+                if (goal_col >= 0) {
+                    this->start_field(goal_col, goal_row);
+                }
+            }
+
+            /** Set the goal; a new field is only started if the goal moved into another cell
+             * \param x_pos The x-position of the goal
+             * \param y_pos The y-position of the goal
+             * \returns Whether a new field was started
+             */
+            bool set_goal(const double &x_pos, const double &y_pos) {
+                if (this->grid == nullptr) {
+                    return false;
+                }
+                const long int col = std::floor(x_pos), row = std::floor(y_pos);
+                const bool matches_building = this->is_field_building && col == this->building_goal_col && row == this->building_goal_row;
+                const bool matches_ready = !this->is_field_building && this->is_field_ready && col == this->goal_col && row == this->goal_row;
+                if (matches_building || matches_ready) {
+                    return false;
+                }
+                this->start_field(col, row);
+                return true;
+            }
+            /** Continue building the field towards the latest goal
+             * \param max_fronts How many fronts (distance steps) can be spread in this call, for spreading a big build over several ticks (the whole field is still rebuilt, just not all in one tick)
+             * \returns Whether a new field was finished (and is now being followed)
+             */
+            bool update(const std::size_t &max_fronts = __SIZE_MAX__) {
+                if (!this->is_field_building) {
+                    return false;
+                }
+                for (std::size_t i = 0; i < max_fronts && this->has_waiting_cells(); i++) {
+                    this->spread_front();
+                }
+                if (this->has_waiting_cells()) {
+                    return false;
+                }
+                this->finish_field();
+                return true;
+            }
+
+            // \brief Get whether there is a field for agents to follow
+            bool is_ready() const {
+                return this->is_field_ready;
+            }
+            // \brief Get whether a new field is still being built
+            bool is_building() const {
+                return this->is_field_building;
+            }
+            // \brief Get the column of the goal of the field being followed
+            long int get_goal_col() const {
+                return this->goal_col;
+            }
+            // \brief Get the row of the goal of the field being followed
+            long int get_goal_row() const {
+                return this->goal_row;
+            }
+
+            /** Get how far a cell is from the goal of the field being followed
+             * \returns The distance (in units where a straight step is straight_cost), or unreachable for walls/cells that can't reach the goal
+             */
+            std::uint32_t get_distance(const std::size_t &col, const std::size_t &row) const {
+                if (!this->is_field_ready || col >= static_cast<std::size_t>(this->cols) || row >= static_cast<std::size_t>(this->rows)) {
+                    return bengine::flow_field_2d::unreachable;
+                }
+                return this->distances[row * this->cols + col];
+            }
+            /** Get the direction that an agent should move in
+             * \param x_pos The x-position of the agent
+             * \param y_pos The y-position of the agent
+             * \returns A unit vector pointing towards the next cell on the way to the goal, or (0, 0) if the agent is at the goal or can't reach it
+             */
+            bengine::coordinate_2d<double> get_direction(const double &x_pos, const double &y_pos) const {
+                if (!this->is_field_ready || x_pos < 0 || y_pos < 0 || x_pos >= this->cols || y_pos >= this->rows) {
+                    return bengine::coordinate_2d<double>(0, 0);
+                }
+                const std::uint8_t direction = this->directions[static_cast<long int>(y_pos) * this->cols + static_cast<long int>(x_pos)];
+                if (direction == bengine::flow_field_2d::no_direction) {
+                    return bengine::coordinate_2d<double>(0, 0);
+                }
+                const double scale = direction < 4 ? 1 : C_SQRT2_2;
+                return bengine::coordinate_2d<double>(bengine::flow_field_2d::get_col_offset(direction) * scale, bengine::flow_field_2d::get_row_offset(direction) * scale);
+            }
+    };
+}
+
+#endif // BENGINE_FLOW_FIELD_hpp
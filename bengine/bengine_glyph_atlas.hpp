@@ -0,0 +1,287 @@
+#ifndef BENGINE_GLYPH_ATLAS_hpp
+#define BENGINE_GLYPH_ATLAS_hpp
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "bengine_render_window.hpp"
+
+namespace bengine {
+    /** Text rendering that rasterizes each glyph of a font once into shared textures (pages), then draws strings as textured quads with a single SDL_RenderGeometry call per page
+     *
+     * Glyphs are rasterized in white and tinted by vertex colors, so one atlas serves every color; unlike bengine::render_window::render_text, nothing is created or destroyed per call, so text that changes every frame is nearly free
+     */
+    class glyph_atlas {
+        public:
+            // \brief Where a glyph is within the pages
+            struct glyph {
+                std::size_t page = 0;
+                SDL_Rect frame = {};
+                // \brief How far to move along after the glyph (px)
+                int advance = 0;
+                // \brief Whether the font lacks the glyph (or it couldn't be rasterized); kept so that it is only attempted once
+                bool is_missing = false;
+            };
+            // \brief A glyph placed within a layout
+            struct quad {
+                std::size_t page;
+                SDL_Rect frame;
+                // \brief The position of the glyph relative to the top-left corner of the text (px)
+                int x_pos;
+                int y_pos;
+            };
+            // \brief A string that has been split into placed glyphs, which can be kept to render static strings without laying them out again
+            class text_layout {
+                friend class bengine::glyph_atlas;
+
+                private:
+                    std::vector<bengine::glyph_atlas::quad> quads;
+                    int width = 0;
+                    int height = 0;
+
+                public:
+                    // \brief Get the width of the text (px)
+                    int get_width() const {
+                        return this->width;
+                    }
+                    // \brief Get the height of the text (px)
+                    int get_height() const {
+                        return this->height;
+                    }
+            };
+
+        private:
+            // \brief The font to rasterize (represents both the font and size of the font; must outlive the atlas)
+            TTF_Font *font;
+            // \brief The side length of each page (px)
+            int page_size;
+            std::vector<SDL_Texture*> pages;
+            // \brief Where the next glyph goes; glyphs are packed left to right in shelves as tall as the tallest glyph in them
+            int shelf_x = 0;
+            int shelf_y = 0;
+            int shelf_height = 0;
+            std::unordered_map<char16_t, bengine::glyph_atlas::glyph> glyphs;
+
+            // \brief Scratch space for text laid out and rendered in one go, and for the quads of each page
+            bengine::glyph_atlas::text_layout scratch_layout;
+            std::vector<std::vector<SDL_Vertex>> page_vertices;
+            std::vector<std::vector<int>> page_indices;
+
+            // \brief Add a blank page to draw glyphs onto
+            bool add_page(bengine::render_window &window) {
+                SDL_Texture *texture = window.create_streaming_texture(this->page_size, this->page_size);
+                if (texture == NULL) {
+                    return false;
+                }
+                SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                const std::vector<Uint32> blank(this->page_size * this->page_size, 0);
+                window.update_texture(texture, {0, 0, this->page_size, this->page_size}, blank.data(), this->page_size * sizeof(Uint32));
+                this->pages.push_back(texture);
+                this->page_vertices.emplace_back();
+                this->page_indices.emplace_back();
+                this->shelf_x = this->shelf_y = this->shelf_height = 0;
+                return true;
+            }
+            /** Get a glyph, rasterizing it onto a page if this is the first time it is used
+             * \returns The glyph, or nullptr if the font does not have it (or it could not be rasterized)
+             */
+            const bengine::glyph_atlas::glyph *get_glyph(bengine::render_window &window, const char16_t &character) {
+                const std::unordered_map<char16_t, bengine::glyph_atlas::glyph>::const_iterator found = this->glyphs.find(character);
+                if (found != this->glyphs.end()) {
+                    return found->second.is_missing ? nullptr : &found->second;
+                }
+                // Glyphs that fail are remembered as missing rather than attempted again every time they come up
+                const auto mark_missing = [&]() {
+                    this->glyphs[character].is_missing = true;
+                    return nullptr;
+                };
+
+                bengine::glyph_atlas::glyph output;
+                int min_x, max_x, min_y, max_y;
+                if (TTF_GlyphMetrics(this->font, character, &min_x, &max_x, &min_y, &max_y, &output.advance) != 0) {
+                    return mark_missing();
+                }
+                // Spaces have nothing to draw
+                if (character != u' ') {
+                    SDL_Surface *surface = TTF_RenderGlyph_Blended(this->font, character, {255, 255, 255, 255});
+                    if (surface == NULL) {
+                        return mark_missing();
+                    }
+                    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+                        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+                        SDL_FreeSurface(surface);
+                        if ((surface = converted) == NULL) {
+                            return mark_missing();
+                        }
+                    }
+                    if (surface->w + 1 > this->page_size || surface->h + 1 > this->page_size) {
+                        SDL_FreeSurface(surface);
+                        return mark_missing();
+                    }
+
+                    // Glyphs are kept a pixel apart so that they don't bleed into each other when scaled
+                    if (this->shelf_x + surface->w + 1 > this->page_size) {
+                        this->shelf_x = 0;
+                        this->shelf_y += this->shelf_height;
+                        this->shelf_height = 0;
+                    }
+                    if (this->pages.empty() || this->shelf_y + surface->h + 1 > this->page_size) {
+                        if (!this->add_page(window)) {
+                            SDL_FreeSurface(surface);
+                            return mark_missing();
+                        }
+                    }
+                    output.page = this->pages.size() - 1;
+                    output.frame = {this->shelf_x, this->shelf_y, surface->w, surface->h};
+                    window.update_texture(this->pages.back(), output.frame, surface->pixels, surface->pitch);
+                    this->shelf_x += surface->w + 1;
+                    this->shelf_height = std::max(this->shelf_height, surface->h + 1);
+                    SDL_FreeSurface(surface);
+                }
+                return &(this->glyphs[character] = output);
+            }
+
+        public:
+            /** Create a glyph atlas (glyphs are rasterized as they are first used)
+             * \param font The font to use (represents both the font and size of the font; must outlive the atlas)
+             * \param page_size The side length of each page (px)
+             */
+            glyph_atlas(TTF_Font *font, const int &page_size = 512) {
+                this->font = font;
+                this->page_size = page_size;
+                if (font == NULL) {
+                    std::cout << "Glyph atlas was given no font, so it will not render any text [bengine::glyph_atlas::glyph_atlas]\n";
+                }
+            }
+            glyph_atlas(const bengine::glyph_atlas &) = delete;
+            bengine::glyph_atlas& operator=(const bengine::glyph_atlas &) = delete;
+            // \brief bengine::glyph_atlas deconstructor; destroys every page
+            ~glyph_atlas() {
+                for (SDL_Texture *page : this->pages) {
+                    SDL_DestroyTexture(page);
+                }
+            }
+
+            // \brief Get how many pages have been filled with glyphs so far
+            std::size_t get_page_count() const {
+                return this->pages.size();
+            }
+
+            /** Lay out text, wrapping it between words like TTF_RenderUNICODE_Blended_Wrapped (nothing is laid out if the atlas has no font)
+             * \param window The window to render the text to (owns the pages)
+             * \param text The text to lay out (supports most unicode characters and line breaks)
+             * \param wrap_width The maximum width for the text (px) (a width of zero prevents any wrapping)
+             * \param output Where to lay the text out to
+             */
+            void layout(bengine::render_window &window, const char16_t *text, const int &wrap_width, bengine::glyph_atlas::text_layout &output) {
+                output.quads.clear();
+                output.width = 0;
+                output.height = 0;
+                if (this->font == NULL) {
+                    return;
+                }
+                const int line_skip = TTF_FontLineSkip(this->font);
+                int pen_x = 0, pen_y = 0;
+                // The first quad after the last space on the current line, along with where the word after the space started and where the line would end if it were broken at the space
+                std::size_t word_start = __SIZE_MAX__;
+                int word_x = 0, break_x = 0;
+                for (const char16_t *character = text; *character != u'\0'; character++) {
+                    if (*character == u'\n') {
+                        output.width = std::max(output.width, pen_x);
+                        pen_x = 0;
+                        pen_y += line_skip;
+                        word_start = __SIZE_MAX__;
+                        continue;
+                    }
+                    const bengine::glyph_atlas::glyph *current = this->get_glyph(window, *character);
+                    if (current == nullptr) {
+                        continue;
+                    }
+                    if (*character == u' ') {
+                        break_x = pen_x;
+                        pen_x += current->advance;
+                        word_start = output.quads.size();
+                        word_x = pen_x;
+                        continue;
+                    }
+
+                    if (wrap_width > 0 && pen_x + current->frame.w > wrap_width && pen_x > 0) {
+                        if (word_start != __SIZE_MAX__) {
+                            // Move the word being written onto the next line
+                            output.width = std::max(output.width, break_x);
+                            for (std::size_t i = word_start; i < output.quads.size(); i++) {
+                                output.quads[i].x_pos -= word_x;
+                                output.quads[i].y_pos += line_skip;
+                            }
+                            pen_x -= word_x;
+                        } else {
+                            output.width = std::max(output.width, pen_x);
+                            pen_x = 0;
+                        }
+                        pen_y += line_skip;
+                        word_start = __SIZE_MAX__;
+                    }
+                    output.quads.push_back({current->page, current->frame, pen_x, pen_y});
+                    pen_x += current->advance;
+                }
+                output.width = std::max(output.width, pen_x);
+                output.height = pen_y + TTF_FontHeight(this->font);
+            }
+            /** Lay out text to be kept and rendered later (for text that rarely changes)
+             * \param window The window to render the text to (owns the pages)
+             * \param text The text to lay out (supports most unicode characters and line breaks)
+             * \param wrap_width The maximum width for the text (px) (a width of zero prevents any wrapping)
+             * \returns The layout
+             */
+            bengine::glyph_atlas::text_layout create_layout(bengine::render_window &window, const char16_t *text, const int &wrap_width = 0) {
+                bengine::glyph_atlas::text_layout output;
+                this->layout(window, text, wrap_width, output);
+                return output;
+            }
+
+            /** Render laid out text
+             * \param window The window to render to (must be the one the text was laid out with)
+             * \param text The laid out text
+             * \param x x-position of the top-left corner of the text (px)
+             * \param y y-position of the top-left corner of the text (px)
+             * \param color The color of the text
+             */
+            void render_layout(bengine::render_window &window, const bengine::glyph_atlas::text_layout &text, const int &x, const int &y, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                for (const bengine::glyph_atlas::quad &glyph_quad : text.quads) {
+                    std::vector<SDL_Vertex> &vertices = this->page_vertices[glyph_quad.page];
+                    std::vector<int> &indices = this->page_indices[glyph_quad.page];
+                    const int first = vertices.size();
+                    const float left = x + glyph_quad.x_pos, top = y + glyph_quad.y_pos, right = left + glyph_quad.frame.w, bottom = top + glyph_quad.frame.h;
+                    const float u1 = static_cast<float>(glyph_quad.frame.x) / this->page_size, v1 = static_cast<float>(glyph_quad.frame.y) / this->page_size;
+                    const float u2 = static_cast<float>(glyph_quad.frame.x + glyph_quad.frame.w) / this->page_size, v2 = static_cast<float>(glyph_quad.frame.y + glyph_quad.frame.h) / this->page_size;
+                    vertices.push_back({{left, top}, color, {u1, v1}});
+                    vertices.push_back({{right, top}, color, {u2, v1}});
+                    vertices.push_back({{right, bottom}, color, {u2, v2}});
+                    vertices.push_back({{left, bottom}, color, {u1, v2}});
+                    indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+                }
+                for (std::size_t page = 0; page < this->pages.size(); page++) {
+                    if (!this->page_vertices[page].empty()) {
+                        window.render_geometry(this->pages[page], this->page_vertices[page], this->page_indices[page]);
+                        this->page_vertices[page].clear();
+                        this->page_indices[page].clear();
+                    }
+                }
+            }
+            /** Lay out and render text in one go (for text that changes often)
+             * \param window The window to render to
+             * \param text The text to display (supports most unicode characters and line breaks)
+             * \param x x-position of the top-left corner of the text (px)
+             * \param y y-position of the top-left corner of the text (px)
+             * \param wrap_width The maximum width for the text (px) (a width of zero prevents any wrapping)
+             * \param color The color of the text
+             */
+            void render_text(bengine::render_window &window, const char16_t *text, const int &x, const int &y, const int &wrap_width = 0, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                this->layout(window, text, wrap_width, this->scratch_layout);
+                this->render_layout(window, this->scratch_layout, x, y, color);
+            }
+    };
+}
+
+#endif // BENGINE_GLYPH_ATLAS_hpp
@@ -0,0 +1,458 @@
+#ifndef BENGINE_GRID_hpp
+#define BENGINE_GRID_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "bengine_helpers.hpp"
+#include "bengine_coordinate_2d.hpp"
+
+namespace bengine {
+    // \brief An abstract grid of 8-bit cells; the memory layout is left up to derived classes so that anything reading the grid (ray traversal, meshing, minimaps) only deals with columns and rows
+    class grid_2d {
+        public:
+            // \brief The different memory layouts that grids can be stored with
+            enum class layout : unsigned char {
+                ROW_MAJOR = 0,    // layout storing each row one after another
+                TILED = 1,        // layout storing small square tiles one after another, with the cells of each tile in Z-order
+                SPARSE = 2        // layout storing only the chunks of the grid that contain solid cells
+            };
+
+            // \brief Information about where a ray traversing the grid hit a solid cell
+            struct ray_hit {
+                // \brief The point that the ray hit the cell at
+                bengine::coordinate_2d<double> position;
+                // \brief The column of the cell that was hit
+                std::size_t col;
+                // \brief The row of the cell that was hit
+                std::size_t row;
+                // \brief How far the ray travelled before hitting the cell
+                double distance;
+                // \brief Whether the ray hit a vertical face of the cell (left/right) or a horizontal face (top/bottom)
+                bool vertical_face;
+            };
+
+        protected:
+            // \brief The amount of columns that the grid has
+            std::size_t cols = 0;
+            // \brief The amount of rows that the grid has
+            std::size_t rows = 0;
+            // \brief Whether the grid can report blocks of empty cells larger than a single cell (see bengine::grid_2d::get_empty_span)
+            bool has_empty_spans = false;
+            // \brief Bumped by every edit/resize, so that anything derived from the grid (e.g. cached ray hits) can tell when it has gone stale
+            std::uint64_t version = 0;
+
+        public:
+            grid_2d() {}
+            virtual ~grid_2d() {}
+
+            std::size_t get_cols() const {
+                return this->cols;
+            }
+            std::size_t get_rows() const {
+                return this->rows;
+            }
+            // \brief Get the edit version of the grid (changes whenever a cell is set or the grid is resized)
+            std::uint64_t get_version() const {
+                return this->version;
+            }
+            bool is_in_bounds(const long int &col, const long int &row) const {
+                return col >= 0 && row >= 0 && static_cast<std::size_t>(col) < this->cols && static_cast<std::size_t>(row) < this->rows;
+            }
+
+            // \brief Get the memory layout that the grid uses
+            virtual bengine::grid_2d::layout get_layout() const = 0;
+            /** Resize the grid, clearing every cell to 0 in the process
+             * \param cols The new amount of columns
+             * \param rows The new amount of rows
+             */
+            virtual void resize(const std::size_t &cols, const std::size_t &rows) = 0;
+            /** Get the value of a cell (no bounds checking is done, see bengine::grid_2d::is_in_bounds)
+             * \param col The column of the cell
+             * \param row The row of the cell
+             * \returns The value of the cell (0 is empty, anything else is solid)
+             */
+            virtual std::uint8_t get_cell(const std::size_t &col, const std::size_t &row) const = 0;
+            /** Set the value of a cell (no bounds checking is done, see bengine::grid_2d::is_in_bounds)
+             * \param col The column of the cell
+             * \param row The row of the cell
+             * \param value The new value of the cell (0 is empty, anything else is solid)
+             */
+            virtual void set_cell(const std::size_t &col, const std::size_t &row, const std::uint8_t &value) = 0;
+
+            bool is_solid(const std::size_t &col, const std::size_t &row) const {
+                return this->get_cell(col, row) > 0;
+            }
+            /** Get the side length of the aligned square block of guaranteed-empty cells that a cell belongs to, letting traversal skip the whole block in one step
+             * \param col The column of the cell
+             * \param row The row of the cell
+             * \returns The side length of the empty block (1 if nothing larger than the cell itself is known to be empty)
+             */
+            virtual std::size_t get_empty_span(const std::size_t &/* col */, const std::size_t &/* row */) const {
+                return 1;
+            }
+
+            /** Copy a rectangular 2D vector into the grid, resizing the grid to match
+             * \param cells The cells to copy, indexed as [row][col]
+             */
+            void load(const std::vector<std::vector<std::uint8_t>> &cells) {
+                this->resize(cells.empty() ? 0 : cells.at(0).size(), cells.size());
+                for (std::size_t row = 0; row < this->rows; row++) {
+                    for (std::size_t col = 0; col < this->cols; col++) {
+                        this->set_cell(col, row, cells.at(row).at(col));
+                    }
+                }
+            }
+
+            /** Walk a ray through the grid one cell at a time (DDA) until it hits a solid cell, leaves the grid, or runs out of range
+             * \param x_pos x-position of the ray's origin (1 unit = 1 cell)
+             * \param y_pos y-position of the ray's origin (1 unit = 1 cell)
+             * \param angle The direction of the ray (radians)
+             * \param range How far the ray can travel before expiring
+             * \returns Information about the hit, or std::nullopt if nothing was hit (a ray starting inside of a solid cell always hits at its origin)
+             */
+            std::optional<bengine::grid_2d::ray_hit> cast_ray(const double &x_pos, const double &y_pos, const double &angle, const double &range) const {
+                long int col = std::floor(x_pos);
+                long int row = std::floor(y_pos);
+                if (!this->is_in_bounds(col, row)) {
+                    return std::nullopt;
+                }
+                if (this->is_solid(col, row)) {
+                    return bengine::grid_2d::ray_hit{bengine::coordinate_2d<double>(x_pos, y_pos), static_cast<std::size_t>(col), static_cast<std::size_t>(row), 0, false};
+                }
+
+                const double x_dir = std::cos(angle);
+                const double y_dir = std::sin(angle);
+                // How far the ray has to travel to cross one whole cell horizontally/vertically
+                const double x_delta = x_dir == 0 ? __DBL_MAX__ : std::fabs(1 / x_dir);
+                const double y_delta = y_dir == 0 ? __DBL_MAX__ : std::fabs(1 / y_dir);
+                const long int x_step = x_dir < 0 ? -1 : 1;
+                const long int y_step = y_dir < 0 ? -1 : 1;
+                // How far the ray has to travel (from its origin) to reach the next vertical/horizontal cell boundary
+                double x_next = x_dir == 0 ? __DBL_MAX__ : (x_dir < 0 ? x_pos - col : col + 1 - x_pos) * x_delta;
+                double y_next = y_dir == 0 ? __DBL_MAX__ : (y_dir < 0 ? y_pos - row : row + 1 - y_pos) * y_delta;
+
+                while (true) {
+                    double distance;
+                    bool vertical_face;
+                    const std::size_t span = this->has_empty_spans ? this->get_empty_span(col, row) : 1;
+                    if (span > 1) {
+                        // The whole (aligned) block is empty, so the ray jumps straight to the first cell outside of it
+                        const long int block_col = col - col % span;
+                        const long int block_row = row - row % span;
+                        const double x_exit = x_dir == 0 ? __DBL_MAX__ : (x_dir < 0 ? x_pos - block_col : block_col + span - x_pos) * x_delta;
+                        const double y_exit = y_dir == 0 ? __DBL_MAX__ : (y_dir < 0 ? y_pos - block_row : block_row + span - y_pos) * y_delta;
+                        if (x_exit < y_exit) {
+                            distance = x_exit;
+                            col = x_dir < 0 ? block_col - 1 : block_col + span;
+                            row = bengine::math_helper::clamp_value_to_range<long int>(std::floor(y_pos + y_dir * distance), block_row, block_row + span - 1);
+                            vertical_face = true;
+                        } else {
+                            distance = y_exit;
+                            row = y_dir < 0 ? block_row - 1 : block_row + span;
+                            col = bengine::math_helper::clamp_value_to_range<long int>(std::floor(x_pos + x_dir * distance), block_col, block_col + span - 1);
+                            vertical_face = false;
+                        }
+                        x_next = x_dir == 0 ? __DBL_MAX__ : (x_dir < 0 ? x_pos - col : col + 1 - x_pos) * x_delta;
+                        y_next = y_dir == 0 ? __DBL_MAX__ : (y_dir < 0 ? y_pos - row : row + 1 - y_pos) * y_delta;
+                    } else if (x_next < y_next) {
+                        distance = x_next;
+                        x_next += x_delta;
+                        col += x_step;
+                        vertical_face = true;
+                    } else {
+                        distance = y_next;
+                        y_next += y_delta;
+                        row += y_step;
+                        vertical_face = false;
+                    }
+
+                    if (distance > range || !this->is_in_bounds(col, row)) {
+                        return std::nullopt;
+                    }
+                    if (this->is_solid(col, row)) {
+                        return bengine::grid_2d::ray_hit{bengine::coordinate_2d<double>(x_pos + x_dir * distance, y_pos + y_dir * distance), static_cast<std::size_t>(col), static_cast<std::size_t>(row), distance, vertical_face};
+                    }
+                }
+            }
+
+            /** Hit the face of a cell that an earlier ray hit with a new ray from the same origin, without walking the grid (e.g. to reuse the hits of the last frame while the camera turns)
+             *
+             * Only the face itself is checked; whether anything is in front of it is up to the caller (a ray between two rays that hit the same face is only blocked by something small enough to fit between them)
+             * \param x_pos x-position of the ray's origin (1 unit = 1 cell)
+             * \param y_pos y-position of the ray's origin (1 unit = 1 cell)
+             * \param angle The direction of the ray (radians)
+             * \param range How far the ray can travel before expiring
+             * \param face An earlier hit on the face to check
+             * \returns Information about the hit, or std::nullopt if the ray misses the face (or runs out of range before reaching it)
+             */
+            std::optional<bengine::grid_2d::ray_hit> cast_ray_at_face(const double &x_pos, const double &y_pos, const double &angle, const double &range, const bengine::grid_2d::ray_hit &face) const {
+                if (face.distance <= 0) {
+                    return std::nullopt;
+                }
+                const double x_dir = std::cos(angle);
+                const double y_dir = std::sin(angle);
+                // The face is on whichever side of the cell the ray comes in from
+                const double along_dir = face.vertical_face ? x_dir : y_dir;
+                if (along_dir == 0) {
+                    return std::nullopt;
+                }
+                const double plane = face.vertical_face ? (x_dir < 0 ? face.col + 1 : face.col) : (y_dir < 0 ? face.row + 1 : face.row);
+                const double distance = (plane - (face.vertical_face ? x_pos : y_pos)) / along_dir;
+                if (distance <= 0 || distance > range) {
+                    return std::nullopt;
+                }
+                const double across = face.vertical_face ? y_pos + y_dir * distance : x_pos + x_dir * distance;
+                const double cell_start = face.vertical_face ? face.row : face.col;
+                if (across < cell_start || across > cell_start + 1) {
+                    return std::nullopt;
+                }
+                return bengine::grid_2d::ray_hit{face.vertical_face ? bengine::coordinate_2d<double>(plane, across) : bengine::coordinate_2d<double>(across, plane), face.col, face.row, distance, face.vertical_face};
+            }
+    };
+
+    // \brief A grid stored one row after another; cheap to index, but rays travelling vertically/diagonally skip across memory quickly on wide grids
+    class row_major_grid_2d : public bengine::grid_2d {
+        private:
+            std::vector<std::uint8_t> cells;
+
+        public:
+            row_major_grid_2d() {}
+            row_major_grid_2d(const std::size_t &cols, const std::size_t &rows) {
+                this->resize(cols, rows);
+            }
+
+            bengine::grid_2d::layout get_layout() const override {
+                return bengine::grid_2d::layout::ROW_MAJOR;
+            }
+            void resize(const std::size_t &cols, const std::size_t &rows) override {
+                this->version++;
+                this->cols = cols;
+                this->rows = rows;
+                this->cells.assign(cols * rows, 0);
+            }
+            std::uint8_t get_cell(const std::size_t &col, const std::size_t &row) const override {
+                return this->cells[row * this->cols + col];
+            }
+            void set_cell(const std::size_t &col, const std::size_t &row, const std::uint8_t &value) override {
+                this->version++;
+                this->cells[row * this->cols + col] = value;
+            }
+    };
+
+    /** A grid stored as 8x8 tiles (one 64-byte cache line each) with the cells of each tile in Z-order (Morton order)
+     *
+     * Any ray crossing a tile stays within a single cache line no matter its direction, which keeps traversal on large grids from thrashing the cache
+     */
+    class tiled_grid_2d : public bengine::grid_2d {
+        public:
+            // \brief The amount of cells along each side of a tile
+            static constexpr std::size_t tile_side_length = 8;
+
+        private:
+            std::vector<std::uint8_t> cells;
+            // \brief The amount of tiles needed to cover one row of cells
+            std::size_t tiles_per_row = 0;
+
+            /** Spread the lower 3 bits of a value out so that there is an empty bit between each of them (0b111 -> 0b10101)
+             * \param value The value to spread out
+             * \returns The spread out value
+             */
+            static std::size_t spread_bits(const std::size_t &value) {
+                return (value & 1) | ((value & 2) << 1) | ((value & 4) << 2);
+            }
+            std::size_t get_index(const std::size_t &col, const std::size_t &row) const {
+                const std::size_t tile = (row >> 3) * this->tiles_per_row + (col >> 3);
+                return (tile << 6) | bengine::tiled_grid_2d::spread_bits(col & 7) | (bengine::tiled_grid_2d::spread_bits(row & 7) << 1);
+            }
+
+        public:
+            tiled_grid_2d() {}
+            tiled_grid_2d(const std::size_t &cols, const std::size_t &rows) {
+                this->resize(cols, rows);
+            }
+
+            bengine::grid_2d::layout get_layout() const override {
+                return bengine::grid_2d::layout::TILED;
+            }
+            void resize(const std::size_t &cols, const std::size_t &rows) override {
+                this->version++;
+                this->cols = cols;
+                this->rows = rows;
+                this->tiles_per_row = (cols + bengine::tiled_grid_2d::tile_side_length - 1) / bengine::tiled_grid_2d::tile_side_length;
+                const std::size_t tiles_per_col = (rows + bengine::tiled_grid_2d::tile_side_length - 1) / bengine::tiled_grid_2d::tile_side_length;
+                this->cells.assign(this->tiles_per_row * tiles_per_col * bengine::tiled_grid_2d::tile_side_length * bengine::tiled_grid_2d::tile_side_length, 0);
+            }
+            std::uint8_t get_cell(const std::size_t &col, const std::size_t &row) const override {
+                return this->cells[this->get_index(col, row)];
+            }
+            void set_cell(const std::size_t &col, const std::size_t &row, const std::uint8_t &value) override {
+                this->version++;
+                this->cells[this->get_index(col, row)] = value;
+            }
+    };
+
+    /** A grid that only stores the 16x16 chunks containing at least one solid cell, kept in an open-addressing hash map
+     *
+     * Meant for huge, mostly-empty maps where a dense grid would waste most of its memory on empty cells; missing chunks are reported as empty spans so that rays cross them in a single step
+     */
+    class sparse_grid_2d : public bengine::grid_2d {
+        public:
+            // \brief The amount of cells along each side of a chunk
+            static constexpr std::size_t chunk_side_length = 16;
+
+        private:
+            struct chunk {
+                // \brief The packed chunk column/row that the chunk is stored under
+                std::uint64_t key;
+                // \brief How many of the chunk's cells are solid; the chunk is released once this reaches 0
+                std::size_t solid_cells;
+                std::uint8_t cells[bengine::sparse_grid_2d::chunk_side_length * bengine::sparse_grid_2d::chunk_side_length];
+            };
+            struct slot {
+                std::uint64_t key;
+                // \brief Index into bengine::sparse_grid_2d::chunks (bengine::sparse_grid_2d::empty_slot if the slot is unused)
+                std::size_t chunk_index;
+            };
+            static constexpr std::size_t empty_slot = __SIZE_MAX__;
+
+            // \brief Every stored chunk, packed together so that iteration/removal doesn't need to touch the hash map
+            std::vector<bengine::sparse_grid_2d::chunk> chunks;
+            // \brief The hash map from chunk keys to chunk indices (linear probing, power-of-two capacity)
+            std::vector<bengine::sparse_grid_2d::slot> slots = std::vector<bengine::sparse_grid_2d::slot>(16, {0, bengine::sparse_grid_2d::empty_slot});
+
+            static std::uint64_t get_key(const std::size_t &col, const std::size_t &row) {
+                return (static_cast<std::uint64_t>(row / bengine::sparse_grid_2d::chunk_side_length) << 32) | static_cast<std::uint64_t>(col / bengine::sparse_grid_2d::chunk_side_length);
+            }
+            static std::size_t get_cell_index(const std::size_t &col, const std::size_t &row) {
+                return (row % bengine::sparse_grid_2d::chunk_side_length) * bengine::sparse_grid_2d::chunk_side_length + col % bengine::sparse_grid_2d::chunk_side_length;
+            }
+            std::size_t get_home_slot(const std::uint64_t &key) const {
+                // Fibonacci hashing spreads neighboring chunks across the table
+                return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (this->slots.size() - 1);
+            }
+            /** Find the slot that a key is stored in, or the empty slot that it would be stored in
+             * \param key The key to search for
+             * \returns The index of the slot
+             */
+            std::size_t find_slot(const std::uint64_t &key) const {
+                std::size_t index = this->get_home_slot(key);
+                while (this->slots[index].chunk_index != bengine::sparse_grid_2d::empty_slot && this->slots[index].key != key) {
+                    index = (index + 1) & (this->slots.size() - 1);
+                }
+                return index;
+            }
+            const bengine::sparse_grid_2d::chunk *find_chunk(const std::size_t &col, const std::size_t &row) const {
+                const std::size_t index = this->find_slot(bengine::sparse_grid_2d::get_key(col, row));
+                return this->slots[index].chunk_index == bengine::sparse_grid_2d::empty_slot ? nullptr : &this->chunks[this->slots[index].chunk_index];
+            }
+            // \brief Double the capacity of the hash map and re-insert every chunk
+            void grow() {
+                this->slots.assign(this->slots.size() * 2, {0, bengine::sparse_grid_2d::empty_slot});
+                for (std::size_t i = 0; i < this->chunks.size(); i++) {
+                    this->slots[this->find_slot(this->chunks[i].key)] = {this->chunks[i].key, i};
+                }
+            }
+            /** Remove a chunk (and its slot) without leaving tombstones behind
+             * \param slot_index The index of the slot holding the chunk
+             */
+            void erase_chunk(const std::size_t &slot_index) {
+                const std::size_t chunk_index = this->slots[slot_index].chunk_index;
+                const std::size_t mask = this->slots.size() - 1;
+
+                // Backward-shift deletion: pull later entries of the probe sequence into the hole as long as that doesn't move them in front of their home slot
+                std::size_t hole = slot_index;
+                std::size_t next = (hole + 1) & mask;
+                while (this->slots[next].chunk_index != bengine::sparse_grid_2d::empty_slot) {
+                    const std::size_t home = this->get_home_slot(this->slots[next].key);
+                    if ((next > hole && (home <= hole || home > next)) || (next < hole && home <= hole && home > next)) {
+                        this->slots[hole] = this->slots[next];
+                        hole = next;
+                    }
+                    next = (next + 1) & mask;
+                }
+                this->slots[hole].chunk_index = bengine::sparse_grid_2d::empty_slot;
+
+                // The last chunk fills in the gap, so its slot has to be pointed at its new index
+                if (chunk_index != this->chunks.size() - 1) {
+                    this->chunks[chunk_index] = this->chunks.back();
+                    this->slots[this->find_slot(this->chunks[chunk_index].key)].chunk_index = chunk_index;
+                }
+                this->chunks.pop_back();
+            }
+
+        public:
+            sparse_grid_2d() {
+                this->has_empty_spans = true;
+            }
+            sparse_grid_2d(const std::size_t &cols, const std::size_t &rows) {
+                this->has_empty_spans = true;
+                this->resize(cols, rows);
+            }
+
+            bengine::grid_2d::layout get_layout() const override {
+                return bengine::grid_2d::layout::SPARSE;
+            }
+            void resize(const std::size_t &cols, const std::size_t &rows) override {
+                this->version++;
+                this->cols = cols;
+                this->rows = rows;
+                this->chunks.clear();
+                this->slots.assign(16, {0, bengine::sparse_grid_2d::empty_slot});
+            }
+            std::uint8_t get_cell(const std::size_t &col, const std::size_t &row) const override {
+                const bengine::sparse_grid_2d::chunk *chunk = this->find_chunk(col, row);
+                return chunk == nullptr ? 0 : chunk->cells[bengine::sparse_grid_2d::get_cell_index(col, row)];
+            }
+            void set_cell(const std::size_t &col, const std::size_t &row, const std::uint8_t &value) override {
+                this->version++;
+                const std::uint64_t key = bengine::sparse_grid_2d::get_key(col, row);
+                const std::size_t cell_index = bengine::sparse_grid_2d::get_cell_index(col, row);
+                std::size_t slot_index = this->find_slot(key);
+
+                if (this->slots[slot_index].chunk_index == bengine::sparse_grid_2d::empty_slot) {
+                    // Empty cells are never stored
+                    if (value == 0) {
+                        return;
+                    }
+                    // Keeping the load factor at or below 1/2 keeps probe sequences short
+                    if ((this->chunks.size() + 1) * 2 > this->slots.size()) {
+                        this->grow();
+                        slot_index = this->find_slot(key);
+                    }
+                    this->chunks.emplace_back();
+                    this->chunks.back().key = key;
+                    this->chunks.back().solid_cells = 0;
+                    std::fill(std::begin(this->chunks.back().cells), std::end(this->chunks.back().cells), 0);
+                    this->slots[slot_index] = {key, this->chunks.size() - 1};
+                }
+
+                bengine::sparse_grid_2d::chunk &chunk = this->chunks[this->slots[slot_index].chunk_index];
+                if (chunk.cells[cell_index] == 0 && value != 0) {
+                    chunk.solid_cells++;
+                } else if (chunk.cells[cell_index] != 0 && value == 0) {
+                    chunk.solid_cells--;
+                }
+                chunk.cells[cell_index] = value;
+
+                if (chunk.solid_cells == 0) {
+                    this->erase_chunk(slot_index);
+                }
+            }
+            std::size_t get_empty_span(const std::size_t &col, const std::size_t &row) const override {
+                return this->find_chunk(col, row) == nullptr ? bengine::sparse_grid_2d::chunk_side_length : 1;
+            }
+
+            /** Get the amount of chunks currently being stored
+             * \returns The amount of chunks currently being stored (each one takes up chunk_side_length^2 bytes plus a small header)
+             */
+            std::size_t get_chunk_count() const {
+                return this->chunks.size();
+            }
+    };
+}
+
+#endif // BENGINE_GRID_hpp
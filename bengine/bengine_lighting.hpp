@@ -0,0 +1,247 @@
+#ifndef BENGINE_LIGHTING_hpp
+#define BENGINE_LIGHTING_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "bengine_visibility.hpp"
+
+namespace bengine {
+    /** A set of point lights inside a bengine::grid_2d, with walls casting shadows
+     *
+     * The area each light reaches is a visibility polygon that is cached until the light moves/grows or a wall within its radius is edited, since most lights sit still
+     */
+    class lighting_2d {
+        public:
+            struct point_light {
+                double x_pos, y_pos;
+                // \brief How far the light reaches (its brightness falls off linearly to nothing at this distance)
+                double radius;
+                // \brief How bright the light is at its center (1 is fully lit)
+                double intensity;
+            };
+
+        private:
+            struct cached_light {
+                bengine::lighting_2d::point_light light;
+                bool is_active;
+                // \brief Whether the polygon needs to be recomputed before it is used again
+                bool is_dirty;
+                // \brief The corners of the lit area, in order of increasing angle around the light
+                std::vector<bengine::coordinate_2d<double>> points;
+                // \brief The angle of each corner around the light (for binary searching)
+                std::vector<double> angles;
+            };
+
+            bengine::visibility_polygon_2d visibility;
+            std::vector<bengine::lighting_2d::cached_light> lights;
+            // \brief IDs of removed lights that can be handed out again
+            std::vector<std::size_t> free_ids;
+            // \brief The brightness of areas that no light reaches
+            double ambient_level = 0;
+
+            /** Find how far a light reaches in a given direction before being blocked
+             * \param light The light (its polygon has to be up to date)
+             * \param angle The direction from the light (radians, between -pi and pi)
+             */
+            static double get_reach(const bengine::lighting_2d::cached_light &light, const double &angle) {
+                const std::size_t size = light.points.size();
+                // The corners on either side of the angle form the edge of the polygon in that direction
+                const std::size_t after = (std::upper_bound(light.angles.begin(), light.angles.end(), angle) - light.angles.begin()) % size;
+                const std::size_t before = (after + size - 1) % size;
+                const double origin_x = light.light.x_pos, origin_y = light.light.y_pos;
+                const double x_1 = light.points[before].get_x_pos() - origin_x, y_1 = light.points[before].get_y_pos() - origin_y;
+                const double x_edge = light.points[after].get_x_pos() - light.points[before].get_x_pos(), y_edge = light.points[after].get_y_pos() - light.points[before].get_y_pos();
+                const double x_dir = std::cos(angle), y_dir = std::sin(angle);
+                const double denominator = x_dir * y_edge - y_dir * x_edge;
+                if (std::fabs(denominator) < 1e-12) {
+                    return std::min(std::sqrt(x_1 * x_1 + y_1 * y_1), light.points[after].get_euclidean_distance_to(bengine::coordinate_2d<double>(origin_x, origin_y)));
+                }
+                return (x_1 * y_edge - y_1 * x_edge) / denominator;
+            }
+
+        public:
+            lighting_2d() {}
+
+            /** Extract the walls of a grid (needed before any lights can be used, and again if the grid is resized); every light is recomputed afterwards
+             * \param grid The grid to extract from
+             */
+            void load(const bengine::grid_2d &grid) {
+                this->visibility.load(grid);
+                for (bengine::lighting_2d::cached_light &light : this->lights) {
+                    light.is_dirty = true;
+                }
+            }
+            /** Update the walls around a cell after it has been edited; only lights that reach the cell are recomputed
+             * \param grid The (already edited) grid
+             * \param col The column of the edited cell
+             * \param row The row of the edited cell
+             */
+            void refresh_cell(const bengine::grid_2d &grid, const std::size_t &col, const std::size_t &row) {
+                this->visibility.refresh_cell(grid, col, row);
+                for (bengine::lighting_2d::cached_light &light : this->lights) {
+                    if (light.is_active && light.light.x_pos + light.light.radius >= col && light.light.x_pos - light.light.radius <= col + 1 && light.light.y_pos + light.light.radius >= row && light.light.y_pos - light.light.radius <= row + 1) {
+                        light.is_dirty = true;
+                    }
+                }
+            }
+
+            double get_ambient_level() const {
+                return this->ambient_level;
+            }
+            void set_ambient_level(const double &level) {
+                this->ambient_level = level;
+            }
+
+            /** Add a light
+             * \param light The light to add
+             * \returns The ID that the light can be referred to with from now on
+             */
+            std::size_t add_light(const bengine::lighting_2d::point_light &light) {
+                std::size_t id;
+                if (this->free_ids.empty()) {
+                    id = this->lights.size();
+                    this->lights.emplace_back();
+                } else {
+                    id = this->free_ids.back();
+                    this->free_ids.pop_back();
+                }
+                this->lights[id].light = light;
+                this->lights[id].is_active = true;
+                this->lights[id].is_dirty = true;
+                return id;
+            }
+            /** Remove a light (its ID may be handed out again by a later addition)
+             * \param id The ID of the light
+             */
+            void remove_light(const std::size_t &id) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                this->lights[id].is_active = false;
+                this->lights[id].points.clear();
+                this->lights[id].angles.clear();
+                this->free_ids.emplace_back(id);
+            }
+            bool contains(const std::size_t &id) const {
+                return id < this->lights.size() && this->lights[id].is_active;
+            }
+            const bengine::lighting_2d::point_light &get_light(const std::size_t &id) const {
+                return this->lights.at(id).light;
+            }
+            /** Move a light; its polygon is only recomputed if it actually moved
+             * \param id The ID of the light
+             * \param x_pos The new x-position of the light
+             * \param y_pos The new y-position of the light
+             */
+            void set_light_position(const std::size_t &id, const double &x_pos, const double &y_pos) {
+                if (!this->contains(id) || (this->lights[id].light.x_pos == x_pos && this->lights[id].light.y_pos == y_pos)) {
+                    return;
+                }
+                this->lights[id].light.x_pos = x_pos;
+                this->lights[id].light.y_pos = y_pos;
+                this->lights[id].is_dirty = true;
+            }
+            void set_light_radius(const std::size_t &id, const double &radius) {
+                if (!this->contains(id) || this->lights[id].light.radius == radius) {
+                    return;
+                }
+                // A smaller radius can reuse the bigger polygon, since the falloff already ends at the radius
+                if (radius > this->lights[id].light.radius) {
+                    this->lights[id].is_dirty = true;
+                }
+                this->lights[id].light.radius = radius;
+            }
+            // \brief Change how bright a light is (never needs its polygon to be recomputed)
+            void set_light_intensity(const std::size_t &id, const double &intensity) {
+                if (this->contains(id)) {
+                    this->lights[id].light.intensity = intensity;
+                }
+            }
+
+            // \brief Get the radius of the biggest light (0 if there are no lights)
+            double get_max_radius() const {
+                double output = 0;
+                for (const bengine::lighting_2d::cached_light &light : this->lights) {
+                    if (light.is_active) {
+                        output = std::max(output, light.light.radius);
+                    }
+                }
+                return output;
+            }
+            // \brief Get a hash of every light and the ambient level, which changes whenever anything affecting how the lights look changes (walls aside)
+            std::uint64_t get_signature() const {
+                std::uint64_t output = 14695981039346656037ull;
+                const auto add = [&](const double &value) {
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    output = (output ^ bits) * 1099511628211ull;
+                };
+                add(this->ambient_level);
+                for (const bengine::lighting_2d::cached_light &light : this->lights) {
+                    if (light.is_active) {
+                        add(light.light.x_pos);
+                        add(light.light.y_pos);
+                        add(light.light.radius);
+                        add(light.light.intensity);
+                    }
+                }
+                return output;
+            }
+
+            /** Recompute the polygons of every light that moved, grew, or had a wall change near it since the last update
+             * \returns How many polygons were recomputed
+             */
+            std::size_t update() {
+                std::size_t output = 0;
+                for (bengine::lighting_2d::cached_light &light : this->lights) {
+                    if (!light.is_active || !light.is_dirty) {
+                        continue;
+                    }
+                    this->visibility.compute(light.light.x_pos, light.light.y_pos, light.light.radius);
+                    light.points = this->visibility.get_points();
+                    light.angles.resize(light.points.size());
+                    for (std::size_t i = 0; i < light.points.size(); i++) {
+                        light.angles[i] = std::atan2(light.points[i].get_y_pos() - light.light.y_pos, light.points[i].get_x_pos() - light.light.x_pos);
+                    }
+                    // Corners at exactly pi come out of atan2 as pi rather than -pi, which would break the ordering
+                    for (std::size_t i = 0; i < light.angles.size() && light.angles[i] >= C_PI; i++) {
+                        light.angles[i] = -C_PI;
+                    }
+                    light.is_dirty = false;
+                    output++;
+                }
+                return output;
+            }
+
+            /** Get how brightly lit a point is (only accurate once bengine::lighting_2d::update has been called after any changes)
+             * \param x_pos The x-position of the point
+             * \param y_pos The y-position of the point
+             * \returns The ambient level plus the contribution of every light that reaches the point (not clamped, so it can go over 1)
+             */
+            double get_light_level(const double &x_pos, const double &y_pos) const {
+                double output = this->ambient_level;
+                for (const bengine::lighting_2d::cached_light &light : this->lights) {
+                    if (!light.is_active || light.points.empty()) {
+                        continue;
+                    }
+                    const double x_difference = x_pos - light.light.x_pos, y_difference = y_pos - light.light.y_pos;
+                    const double distance_squared = x_difference * x_difference + y_difference * y_difference;
+                    if (distance_squared >= light.light.radius * light.light.radius) {
+                        continue;
+                    }
+                    const double distance = std::sqrt(distance_squared);
+                    if (distance > 0 && distance > bengine::lighting_2d::get_reach(light, std::atan2(y_difference, x_difference))) {
+                        continue;
+                    }
+                    output += light.light.intensity * (1 - distance / light.light.radius);
+                }
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_LIGHTING_hpp
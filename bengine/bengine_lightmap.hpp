@@ -0,0 +1,295 @@
+#ifndef BENGINE_LIGHTMAP_hpp
+#define BENGINE_LIGHTMAP_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bengine_grid.hpp"
+#include "bengine_lighting.hpp"
+#include "bengine_worker_pool.hpp"
+
+namespace bengine {
+    /** Light from a bengine::lighting_2d baked into a table, so that shading static lights at runtime is just a lookup
+     *
+     * Every empty cell stores how lit its floor is and every solid cell stores how lit each of its 4 faces is, with ambient occlusion from the walls around them baked in as well
+     * Baking is split across a bengine::worker_pool (if given), and editing a cell only requires the area that the lights can reach from it to be rebaked
+     */
+    class lightmap_2d {
+        public:
+            // \brief The faces of a solid cell (north is towards row 0, west is towards col 0)
+            enum class face : unsigned char {
+                NORTH = 0,
+                EAST = 1,
+                SOUTH = 2,
+                WEST = 3
+            };
+
+        private:
+            std::size_t cols = 0;
+            std::size_t rows = 0;
+            // \brief The light level of each cell's floor (0-255 maps to 0-1)
+            std::vector<std::uint8_t> floor_levels;
+            // \brief The light level of each face of each cell (4 per cell, in bengine::lightmap_2d::face order)
+            std::vector<std::uint8_t> face_levels;
+            // \brief A hash of the grid and lights that the lightmap was baked from (see bengine::lightmap_2d::get_signature)
+            std::uint64_t signature = 0;
+            // \brief Whether cells have been rebaked since bengine::lightmap_2d::signature was computed (it is recomputed when the lightmap is saved)
+            bool signature_stale = false;
+
+            // \brief How much each neighboring wall darkens a floor/face
+            static constexpr double occlusion_strength = 0.12;
+            // \brief Rows baked per task handed to the worker pool
+            static constexpr std::size_t rows_per_task = 4;
+            // \brief Identifies lightmap files (and their version)
+            static constexpr std::uint32_t file_magic = 0x314d4c42;
+
+            static bool is_blocking(const bengine::grid_2d &grid, const long int &col, const long int &row) {
+                return !grid.is_in_bounds(col, row) || grid.is_solid(col, row);
+            }
+            static std::uint8_t to_level(const double &light) {
+                return std::clamp(light, 0.0, 1.0) * 255 + 0.5;
+            }
+
+            // \brief Bake the floor of an empty cell; the light is averaged over 4 points in the cell to soften shadow edges
+            std::uint8_t bake_floor(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting, const long int &col, const long int &row) const {
+                double light = 0;
+                for (unsigned char i = 0; i < 4; i++) {
+                    light += lighting.get_light_level(col + 0.25 + 0.5 * (i % 2), row + 0.25 + 0.5 * (i / 2)) / 4;
+                }
+                // Cells tucked into corners/hallways catch less bounced light
+                unsigned char neighbors = 0;
+                for (long int row_offset = -1; row_offset <= 1; row_offset++) {
+                    for (long int col_offset = -1; col_offset <= 1; col_offset++) {
+                        neighbors += (row_offset != 0 || col_offset != 0) && bengine::lightmap_2d::is_blocking(grid, col + col_offset, row + row_offset);
+                    }
+                }
+                // Floors never bake to 0, which is reserved for walls
+                return std::max<std::uint8_t>(1, bengine::lightmap_2d::to_level(light * (1 - bengine::lightmap_2d::occlusion_strength * neighbors / 2)));
+            }
+            // \brief Bake one face of a solid cell; faces covered by another wall stay dark
+            std::uint8_t bake_face(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting, const long int &col, const long int &row, const unsigned char &face) const {
+                // The direction that the face points in, and the direction along it
+                const long int x_normal = face == 1 ? 1 : (face == 3 ? -1 : 0), y_normal = face == 2 ? 1 : (face == 0 ? -1 : 0);
+                const long int x_along = y_normal != 0 ? 1 : 0, y_along = x_normal != 0 ? 1 : 0;
+                if (bengine::lightmap_2d::is_blocking(grid, col + x_normal, row + y_normal)) {
+                    return 0;
+                }
+
+                // The face is sampled at 2 points just in front of it (the face itself lies exactly on the edge of every light's polygon)
+                const double center_x = col + 0.5 + x_normal * (0.5 + 1e-3), center_y = row + 0.5 + y_normal * (0.5 + 1e-3);
+                const double light = (lighting.get_light_level(center_x - x_along * 0.25, center_y - y_along * 0.25) + lighting.get_light_level(center_x + x_along * 0.25, center_y + y_along * 0.25)) / 2;
+                // Walls sticking out next to the face form inside corners, which are darker
+                const unsigned char corners = bengine::lightmap_2d::is_blocking(grid, col + x_normal - x_along, row + y_normal - y_along) + bengine::lightmap_2d::is_blocking(grid, col + x_normal + x_along, row + y_normal + y_along);
+                return bengine::lightmap_2d::to_level(light * (1 - bengine::lightmap_2d::occlusion_strength * corners));
+            }
+            void bake_row(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting, const std::size_t &row, const std::size_t &first_col, const std::size_t &last_col) {
+                for (std::size_t col = first_col; col <= last_col; col++) {
+                    const std::size_t cell = row * this->cols + col;
+                    if (grid.is_solid(col, row)) {
+                        this->floor_levels[cell] = 0;
+                        for (unsigned char face = 0; face < 4; face++) {
+                            this->face_levels[cell * 4 + face] = this->bake_face(grid, lighting, col, row, face);
+                        }
+                    } else {
+                        this->floor_levels[cell] = this->bake_floor(grid, lighting, col, row);
+                        std::fill(this->face_levels.begin() + cell * 4, this->face_levels.begin() + cell * 4 + 4, 0);
+                    }
+                }
+            }
+
+        public:
+            lightmap_2d() {}
+
+            std::size_t get_cols() const {
+                return this->cols;
+            }
+            std::size_t get_rows() const {
+                return this->rows;
+            }
+
+            /** Get a hash identifying a grid and set of lights, used to check whether a saved lightmap still matches them
+             * \param grid The grid
+             * \param lighting The lights
+             */
+            static std::uint64_t get_signature(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting) {
+                std::uint64_t output = lighting.get_signature();
+                output = (output ^ grid.get_cols()) * 1099511628211ull;
+                output = (output ^ grid.get_rows()) * 1099511628211ull;
+                for (std::size_t row = 0; row < grid.get_rows(); row++) {
+                    for (std::size_t col = 0; col < grid.get_cols(); col++) {
+                        output = (output ^ grid.get_cell(col, row)) * 1099511628211ull;
+                    }
+                }
+                return output;
+            }
+            /** Bake the whole grid (the lights have to be up to date, see bengine::lighting_2d::update)
+             * \param grid The grid to bake
+             * \param lighting The lights to bake
+             * \param workers The threads to bake with, or nullptr to bake on the calling thread
+             */
+            void bake(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting, bengine::worker_pool *workers = nullptr) {
+                this->cols = grid.get_cols();
+                this->rows = grid.get_rows();
+                this->floor_levels.assign(this->cols * this->rows, 0);
+                this->face_levels.assign(this->cols * this->rows * 4, 0);
+                if (this->cols > 0 && this->rows > 0) {
+                    this->rebake(grid, lighting, 0, 0, this->cols - 1, this->rows - 1, workers);
+                }
+                this->signature = bengine::lightmap_2d::get_signature(grid, lighting);
+                this->signature_stale = false;
+            }
+            /** Rebake a rectangle of cells (the lights have to be up to date, and the grid can't have been resized since the last full bake)
+             * \param first_col The left column of the rectangle
+             * \param first_row The top row of the rectangle
+             * \param last_col The right column of the rectangle (inclusive)
+             * \param last_row The bottom row of the rectangle (inclusive)
+             */
+            void rebake(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting, const std::size_t &first_col, const std::size_t &first_row, const std::size_t &last_col, const std::size_t &last_row, bengine::worker_pool *workers = nullptr) {
+                if (this->cols == 0 || this->rows == 0 || first_col >= this->cols || first_row >= this->rows) {
+                    return;
+                }
+                const std::size_t clamped_last_col = std::min(last_col, this->cols - 1), clamped_last_row = std::min(last_row, this->rows - 1);
+                if (first_col > clamped_last_col || first_row > clamped_last_row) {
+                    return;
+                }
+                // Each task writes to its own rows only
+                const auto bake_rows = [&](const std::size_t &begin, const std::size_t &end) {
+                    for (std::size_t row = first_row + begin; row < first_row + end; row++) {
+                        this->bake_row(grid, lighting, row, first_col, clamped_last_col);
+                    }
+                };
+                if (workers == nullptr) {
+                    bake_rows(0, clamped_last_row - first_row + 1);
+                } else {
+                    workers->run_chunked(clamped_last_row - first_row + 1, bengine::lightmap_2d::rows_per_task, bake_rows);
+                }
+            }
+            /** Rebake everything that editing a cell could have changed: the area that lights can reach from the cell, plus its neighbors (for occlusion)
+             * \param grid The (already edited) grid
+             * \param lighting The lights (already refreshed with bengine::lighting_2d::refresh_cell and updated)
+             * \param col The column of the edited cell
+             * \param row The row of the edited cell
+             */
+            void rebake_cell(const bengine::grid_2d &grid, const bengine::lighting_2d &lighting, const std::size_t &col, const std::size_t &row, bengine::worker_pool *workers = nullptr) {
+                // A light that now casts a different shadow from the cell reaches the cell, so everything else it affects is within its diameter
+                const std::size_t reach = std::ceil(lighting.get_max_radius() * 2) + 1;
+                this->rebake(grid, lighting, col > reach ? col - reach : 0, row > reach ? row - reach : 0, col + reach, row + reach, workers);
+                // Hashing the whole grid here would make every edit cost as much as a full bake, so that waits until the lightmap is saved
+                this->signature_stale = true;
+            }
+
+            // \brief Get the baked light level of a cell's floor (0-1)
+            double get_floor_level(const std::size_t &col, const std::size_t &row) const {
+                return col < this->cols && row < this->rows ? this->floor_levels[row * this->cols + col] / 255.0 : 0;
+            }
+            /** Get the baked light level of a point on the floor, blended between the 4 nearest cell centers
+             * \param x_pos The x-position of the point
+             * \param y_pos The y-position of the point
+             * \returns The light level (0-1)
+             */
+            double get_floor_level(const double &x_pos, const double &y_pos) const {
+                const double x = x_pos - 0.5, y = y_pos - 0.5;
+                const long int col = std::floor(x), row = std::floor(y);
+                const double x_weight = x - col, y_weight = y - row;
+                // Walls have no floor, so they are left out of the blend rather than darkening it
+                double total = 0, weights = 0;
+                for (unsigned char i = 0; i < 4; i++) {
+                    const long int sample_col = col + i % 2, sample_row = row + i / 2;
+                    if (sample_col < 0 || sample_row < 0 || static_cast<std::size_t>(sample_col) >= this->cols || static_cast<std::size_t>(sample_row) >= this->rows || this->floor_levels[sample_row * this->cols + sample_col] == 0) {
+                        continue;
+                    }
+                    const double weight = (i % 2 ? x_weight : 1 - x_weight) * (i / 2 ? y_weight : 1 - y_weight);
+                    total += weight * this->floor_levels[sample_row * this->cols + sample_col] / 255.0;
+                    weights += weight;
+                }
+                return weights > 0 ? total / weights : 0;
+            }
+            // \brief Get the baked light level of one face of a cell (0-1)
+            double get_face_level(const std::size_t &col, const std::size_t &row, const bengine::lightmap_2d::face &face) const {
+                return col < this->cols && row < this->rows ? this->face_levels[(row * this->cols + col) * 4 + static_cast<unsigned char>(face)] / 255.0 : 0;
+            }
+            /** Get the baked light level of the face that a ray hit
+             * \param hit The hit
+             * \param angle The direction of the ray that hit the face (radians)
+             */
+            double get_face_level(const bengine::grid_2d::ray_hit &hit, const double &angle) const {
+                if (hit.vertical_face) {
+                    return this->get_face_level(hit.col, hit.row, std::cos(angle) > 0 ? bengine::lightmap_2d::face::WEST : bengine::lightmap_2d::face::EAST);
+                }
+                return this->get_face_level(hit.col, hit.row, std::sin(angle) > 0 ? bengine::lightmap_2d::face::NORTH : bengine::lightmap_2d::face::SOUTH);
+            }
+
+            /** Save the lightmap to a file
+             * \param path The path of the file
+             * \param grid The grid that the lightmap was baked from (only hashed if cells were rebaked since the last full bake, load, or save)
+             * \param lighting The lights that the lightmap was baked from
+             * \returns 0 on success or -1 on failure
+             */
+            int save(const std::string &path, const bengine::grid_2d &grid, const bengine::lighting_2d &lighting) {
+                if (this->signature_stale) {
+                    this->signature = bengine::lightmap_2d::get_signature(grid, lighting);
+                    this->signature_stale = false;
+                }
+                std::ofstream file(path, std::ios::binary);
+                if (!file) {
+                    std::cout << "Failed to open \"" << path << "\" for writing [bengine::lightmap_2d::save]\n";
+                    return -1;
+                }
+                const std::uint64_t header[3] = {bengine::lightmap_2d::file_magic, this->cols, this->rows};
+                file.write(reinterpret_cast<const char*>(header), sizeof(header));
+                file.write(reinterpret_cast<const char*>(&this->signature), sizeof(this->signature));
+                file.write(reinterpret_cast<const char*>(this->floor_levels.data()), this->floor_levels.size());
+                file.write(reinterpret_cast<const char*>(this->face_levels.data()), this->face_levels.size());
+                if (!file) {
+                    std::cout << "Failed to write to \"" << path << "\" [bengine::lightmap_2d::save]\n";
+                    return -1;
+                }
+                return 0;
+            }
+            /** Load a lightmap saved with bengine::lightmap_2d::save
+             * \param path The path of the file
+             * \param grid The grid that the lightmap has to have been baked for (files of any other size are rejected before anything is allocated)
+             * \param signature The signature that the lightmap has to have been baked with (see bengine::lightmap_2d::get_signature), so that stale lightmaps are rejected
+             * \returns 0 on success or -1 if the file is missing, invalid, or stale (the lightmap is left untouched in that case)
+             */
+            int load(const std::string &path, const bengine::grid_2d &grid, const std::uint64_t &signature) {
+                std::ifstream file(path, std::ios::binary);
+                if (!file) {
+                    return -1;
+                }
+                std::uint64_t header[3], file_signature;
+                file.read(reinterpret_cast<char*>(header), sizeof(header));
+                file.read(reinterpret_cast<char*>(&file_signature), sizeof(file_signature));
+                if (!file || header[0] != bengine::lightmap_2d::file_magic || file_signature != signature) {
+                    return -1;
+                }
+                // The sizes come straight from the file, so they are checked before being trusted with an allocation
+                if (header[1] != grid.get_cols() || header[2] != grid.get_rows()) {
+                    std::cout << "Lightmap \"" << path << "\" does not match the size of the grid [bengine::lightmap_2d::load]\n";
+                    return -1;
+                }
+                std::vector<std::uint8_t> floor_levels(header[1] * header[2]), face_levels(header[1] * header[2] * 4);
+                file.read(reinterpret_cast<char*>(floor_levels.data()), floor_levels.size());
+                file.read(reinterpret_cast<char*>(face_levels.data()), face_levels.size());
+                if (!file) {
+                    std::cout << "Lightmap \"" << path << "\" is truncated [bengine::lightmap_2d::load]\n";
+                    return -1;
+                }
+                this->cols = header[1];
+                this->rows = header[2];
+                this->floor_levels.swap(floor_levels);
+                this->face_levels.swap(face_levels);
+                this->signature = file_signature;
+                this->signature_stale = false;
+                return 0;
+            }
+    };
+}
+
+#endif // BENGINE_LIGHTMAP_hpp
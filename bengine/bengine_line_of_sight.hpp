@@ -0,0 +1,172 @@
+#ifndef BENGINE_LINE_OF_SIGHT_hpp
+#define BENGINE_LINE_OF_SIGHT_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "bengine_grid.hpp"
+#include "bengine_aabb_tree.hpp"
+#include "bengine_worker_pool.hpp"
+
+namespace bengine {
+    /** Answers batches of "can A see B" queries against walls (a bengine::grid_2d) and/or moving colliders (a bengine::aabb_tree_2d)
+     *
+     * Game logic submits queries throughout a tick and then solves them all at once; the queries are sorted so that nearby ones run back to back (keeping the parts of the grid/tree they touch in cache) and are spread across a bengine::worker_pool if one is set
+     */
+    class line_of_sight_2d {
+        public:
+            // \brief Whatever stopped a line of sight query
+            struct blocking_hit {
+                bengine::coordinate_2d<double> position;
+                // \brief How far the hit is from the start of the query
+                double distance;
+                // \brief Whether the query was blocked by a wall (true) or a collider (false)
+                bool is_wall;
+                // \brief The cell that was hit (only valid for walls)
+                std::size_t col, row;
+                // \brief The ID of the collider that was hit (only valid for colliders)
+                std::size_t collider_id;
+            };
+            struct result {
+                bool is_visible;
+                // \brief What blocked the query (std::nullopt if the target is visible)
+                std::optional<bengine::line_of_sight_2d::blocking_hit> hit;
+            };
+
+        private:
+            struct query {
+                double from_x, from_y, to_x, to_y;
+                // \brief Colliders that can't block the query (usually the ones belonging to the viewer and the target)
+                std::optional<std::size_t> ignored_id_1, ignored_id_2;
+            };
+
+            const bengine::grid_2d *grid = nullptr;
+            const bengine::aabb_tree_2d *colliders = nullptr;
+            bengine::worker_pool *workers = nullptr;
+
+            std::vector<bengine::line_of_sight_2d::query> queries;
+            std::vector<bengine::line_of_sight_2d::result> results;
+            // \brief The order that queries are solved in, along with the keys they were sorted by
+            std::vector<std::pair<std::uint64_t, std::size_t>> order;
+
+            // \brief Queries per task handed to the worker pool
+            static constexpr std::size_t chunk_size = 64;
+
+            // \brief Interleave the bits of two cell coordinates so that queries starting in nearby cells sort next to each other
+            static std::uint64_t get_morton_key(const double &x_pos, const double &y_pos) {
+                std::uint64_t output = 0;
+                const std::uint32_t col = static_cast<std::uint32_t>(static_cast<std::int64_t>(std::floor(x_pos)));
+                const std::uint32_t row = static_cast<std::uint32_t>(static_cast<std::int64_t>(std::floor(y_pos)));
+                for (unsigned char i = 0; i < 32; i++) {
+                    output |= (static_cast<std::uint64_t>((col >> i) & 1) << (2 * i)) | (static_cast<std::uint64_t>((row >> i) & 1) << (2 * i + 1));
+                }
+                return output;
+            }
+
+            bengine::line_of_sight_2d::result solve_query(const bengine::line_of_sight_2d::query &query) const {
+                const double x_difference = query.to_x - query.from_x, y_difference = query.to_y - query.from_y;
+                const double distance = std::sqrt(x_difference * x_difference + y_difference * y_difference);
+                const double angle = std::atan2(y_difference, x_difference);
+                std::optional<bengine::line_of_sight_2d::blocking_hit> output = std::nullopt;
+
+                if (this->grid != nullptr) {
+                    const std::optional<bengine::grid_2d::ray_hit> wall = this->grid->cast_ray(query.from_x, query.from_y, angle, distance);
+                    // A wall exactly at the target (e.g. the target standing against it) doesn't count as blocking
+                    if (wall.has_value() && wall.value().distance < distance) {
+                        output = bengine::line_of_sight_2d::blocking_hit{wall.value().position, wall.value().distance, true, wall.value().col, wall.value().row, 0};
+                    }
+                }
+                if (this->colliders != nullptr) {
+                    // Anything past the wall that was hit can't be closer, so the collider search stops there
+                    const double range = output.has_value() ? output.value().distance : distance;
+                    const std::optional<bengine::aabb_tree_2d::ray_hit> collider = this->colliders->cast_ray_filtered(query.from_x, query.from_y, angle, range, [&](const std::size_t &id) {
+                        return (query.ignored_id_1.has_value() && query.ignored_id_1.value() == id) || (query.ignored_id_2.has_value() && query.ignored_id_2.value() == id);
+                    });
+                    if (collider.has_value() && collider.value().distance < range) {
+                        output = bengine::line_of_sight_2d::blocking_hit{collider.value().position, collider.value().distance, false, 0, 0, collider.value().id};
+                    }
+                }
+                return bengine::line_of_sight_2d::result{!output.has_value(), output};
+            }
+
+        public:
+            line_of_sight_2d() {}
+
+            /** Set the walls that block sight
+             * \param grid The walls (must outlive the queries being solved), or nullptr to ignore walls
+             */
+            void set_grid(const bengine::grid_2d *grid) {
+                this->grid = grid;
+            }
+            /** Set the moving colliders that block sight
+             * \param colliders The colliders (must outlive the queries being solved), or nullptr to ignore colliders
+             */
+            void set_colliders(const bengine::aabb_tree_2d *colliders) {
+                this->colliders = colliders;
+            }
+            /** Set the threads used to solve queries; results are the same no matter how many threads there are
+             * \param workers The threads to use, or nullptr to solve everything on the calling thread
+             */
+            void set_worker_pool(bengine::worker_pool *workers) {
+                this->workers = workers;
+            }
+
+            // \brief Get the amount of queries submitted since the last call to bengine::line_of_sight_2d::clear
+            std::size_t get_query_count() const {
+                return this->queries.size();
+            }
+
+            /** Add a query to the current batch
+             * \param from_x The x-position of the viewer
+             * \param from_y The y-position of the viewer
+             * \param to_x The x-position of the target
+             * \param to_y The y-position of the target
+             * \param ignored_id_1 A collider that can't block the query (usually the viewer's)
+             * \param ignored_id_2 Another collider that can't block the query (usually the target's)
+             * \returns The index that the query's result can be found at once the batch is solved
+             */
+            std::size_t submit(const double &from_x, const double &from_y, const double &to_x, const double &to_y, const std::optional<std::size_t> &ignored_id_1 = std::nullopt, const std::optional<std::size_t> &ignored_id_2 = std::nullopt) {
+                this->queries.push_back({from_x, from_y, to_x, to_y, ignored_id_1, ignored_id_2});
+                return this->queries.size() - 1;
+            }
+            // \brief Solve every query in the current batch (queries submitted after this need another call)
+            void solve() {
+                const std::size_t size = this->queries.size();
+                this->results.resize(size);
+
+                this->order.resize(size);
+                for (std::size_t i = 0; i < size; i++) {
+                    this->order[i] = std::make_pair(bengine::line_of_sight_2d::get_morton_key(this->queries[i].from_x, this->queries[i].from_y), i);
+                }
+                std::sort(this->order.begin(), this->order.end());
+
+                const auto solve_range = [&](const std::size_t &begin, const std::size_t &end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        const std::size_t index = this->order[i].second;
+                        this->results[index] = this->solve_query(this->queries[index]);
+                    }
+                };
+                if (this->workers == nullptr) {
+                    solve_range(0, size);
+                } else {
+                    this->workers->run_chunked(size, bengine::line_of_sight_2d::chunk_size, solve_range);
+                }
+            }
+            /** Get the result of a query (only valid once the batch has been solved)
+             * \param index The index returned when the query was submitted
+             */
+            const bengine::line_of_sight_2d::result &get_result(const std::size_t &index) const {
+                return this->results.at(index);
+            }
+            // \brief Start a new batch, throwing away every query and result
+            void clear() {
+                this->queries.clear();
+                this->results.clear();
+            }
+    };
+}
+
+#endif // BENGINE_LINE_OF_SIGHT_hpp
@@ -16,6 +16,8 @@ namespace bengine {
             bool loop_running = true;
             // \brief Whether the renderer needs to update the visuals or not (saves on performance when nothing visual is happening)
             bool visuals_changed = true;
+            // \brief How long the last rendering frame took to clear, render and present (ms)
+            double render_time = 0;
 
             // \brief The window that is interacted with and displays everything
             bengine::render_window window = bengine::render_window("window", 1280, 720, SDL_WINDOW_SHOWN);
@@ -107,9 +109,11 @@ namespace bengine {
 
                     if (this->visuals_changed) {
                         this->visuals_changed = false;
+                        const Uint64 render_start = SDL_GetPerformanceCounter();
                         this->window.clear_renderer();
                         this->render();
                         this->window.present_renderer();
+                        this->render_time = (SDL_GetPerformanceCounter() - render_start) * 1000.0 / SDL_GetPerformanceFrequency();
                     }
 
                     if ((frame_ticks = SDL_GetTicks() - start_ticks) < (Uint32)(1000 / this->window.get_refresh_rate())) {
@@ -0,0 +1,531 @@
+#ifndef BENGINE_PATHFINDING_hpp
+#define BENGINE_PATHFINDING_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bengine_grid.hpp"
+
+namespace bengine {
+    /** Finds paths through the empty cells of a bengine::grid_2d, using A* with jump point search (moving in 8 directions, without cutting corners)
+     *
+     * Walkability is kept as a bit-packed copy of the grid, and every array used by a search is allocated up front and stamped with the search it was last touched by, so searches never allocate or clear memory
+     * Paths are smoothed by skipping waypoints that can be seen past, and the smoothed paths are cached by the regions that they start/end in so that agents heading the same way can share them
+     */
+    class pathfinder_2d {
+        private:
+            struct node {
+                // \brief The cost of the best known path to the node
+                double g;
+                // \brief The cost of the best known path to the node plus the estimated cost from the node to the goal
+                double f;
+                std::uint32_t parent;
+                // \brief The search that the node was last touched by (the rest of the node is stale if this isn't the current search)
+                std::uint32_t generation;
+                // \brief Where the node is in the open heap
+                std::uint32_t heap_index;
+                bool is_closed;
+            };
+            struct cache_slot {
+                std::uint64_t key;
+                // \brief The cache version that the slot was filled in (the slot is empty if this isn't the current version)
+                std::uint32_t version;
+                // \brief Where the slot's waypoints start in the cache's waypoint pool, and how many there are
+                std::uint32_t offset, count;
+            };
+
+            static constexpr std::uint32_t null_index = UINT32_MAX;
+
+            // \brief The grid being searched (must outlive the pathfinder)
+            const bengine::grid_2d *grid = nullptr;
+            long int cols = 0;
+            long int rows = 0;
+            // \brief Whether each cell is empty, 64 cells per word (each row starts on a new word)
+            std::vector<std::uint64_t> walkable_bits;
+            std::size_t words_per_row = 0;
+            // \brief The same as walkable_bits but with columns in place of rows, so that vertical jumps can scan whole words too
+            std::vector<std::uint64_t> transposed_bits;
+            std::size_t words_per_col = 0;
+
+            std::vector<bengine::pathfinder_2d::node> nodes;
+            std::uint32_t generation = 0;
+            // \brief A binary min-heap of open nodes (by f), allocated to fit every cell
+            std::vector<std::uint32_t> heap;
+            std::size_t heap_size = 0;
+            // \brief The jump points of the last path found, from start to goal
+            std::vector<std::uint32_t> jump_points;
+            // \brief Waypoints of the last path before smoothing
+            std::vector<bengine::coordinate_2d<double>> raw_path;
+
+            // \brief The side length of the square regions that paths are cached by
+            std::size_t region_size;
+            std::vector<bengine::pathfinder_2d::cache_slot> cache_slots;
+            // \brief The waypoints of every cached path, back to back
+            std::vector<bengine::coordinate_2d<double>> cache_points;
+            std::uint32_t cache_version = 1;
+            std::size_t cache_hits = 0;
+            std::size_t searches = 0;
+
+            // \brief How far (perpendicular to the path) that smoothing keeps the path from walls
+            double clearance;
+
+            bool is_walkable(const long int &col, const long int &row) const {
+                if (col < 0 || row < 0 || col >= this->cols || row >= this->rows) {
+                    return false;
+                }
+                return (this->walkable_bits[row * this->words_per_row + col / 64] >> (col % 64)) & 1;
+            }
+            std::uint32_t get_index(const long int &col, const long int &row) const {
+                return row * this->cols + col;
+            }
+            // \brief Get the cost of moving between two cells along a straight/diagonal line (or an estimate of it if they aren't on one)
+            static double get_octile_distance(const long int &col_1, const long int &row_1, const long int &col_2, const long int &row_2) {
+                const long int col_difference = std::labs(col_1 - col_2), row_difference = std::labs(row_1 - row_2);
+                return std::max(col_difference, row_difference) + (C_SQRT2 - 1) * std::min(col_difference, row_difference);
+            }
+
+            bool is_heap_before(const std::uint32_t &index_1, const std::uint32_t &index_2) const {
+                const bengine::pathfinder_2d::node &node_1 = this->nodes[index_1], &node_2 = this->nodes[index_2];
+                // Ties go to the node further along, which reaches the goal sooner
+                return node_1.f < node_2.f || (node_1.f == node_2.f && node_1.g > node_2.g);
+            }
+            void sift_up(std::size_t position) {
+                const std::uint32_t index = this->heap[position];
+                while (position > 0 && this->is_heap_before(index, this->heap[(position - 1) / 2])) {
+                    this->heap[position] = this->heap[(position - 1) / 2];
+                    this->nodes[this->heap[position]].heap_index = position;
+                    position = (position - 1) / 2;
+                }
+                this->heap[position] = index;
+                this->nodes[index].heap_index = position;
+            }
+            std::uint32_t pop_heap() {
+                const std::uint32_t output = this->heap[0];
+                const std::uint32_t last = this->heap[--this->heap_size];
+                std::size_t position = 0;
+                while (position * 2 + 1 < this->heap_size) {
+                    std::size_t child = position * 2 + 1;
+                    if (child + 1 < this->heap_size && this->is_heap_before(this->heap[child + 1], this->heap[child])) {
+                        child++;
+                    }
+                    if (!this->is_heap_before(this->heap[child], last)) {
+                        break;
+                    }
+                    this->heap[position] = this->heap[child];
+                    this->nodes[this->heap[position]].heap_index = position;
+                    position = child;
+                }
+                this->heap[position] = last;
+                this->nodes[last].heap_index = position;
+                return output;
+            }
+
+            /** Scan along a row (or a column, using the transposed bits) for the first jump point, 64 cells at a time
+             *
+             * A jump point is a cell where a wall beside the line ends, opening up a route that can only be reached optimally by turning there
+             * \param bits The bits to scan (walkable_bits for rows, transposed_bits for columns)
+             * \param words_per_line How many words each line of the bits takes up
+             * \param line_count How many lines there are
+             * \param line The line to scan along
+             * \param position Where along the line to start
+             * \param direction 1 to scan forwards, -1 to scan backwards
+             * \param goal_position Where the goal is along the line (-1 if it isn't on the line), which counts as a jump point
+             * \returns The position of the jump point along the line, or -1 if a wall is reached first
+             */
+            static long int scan_line(const std::vector<std::uint64_t> &bits, const std::size_t &words_per_line, const long int &line_count, const long int &line, const long int &position, const long int &direction, const long int &goal_position) {
+                if (position < 0 || position >= static_cast<long int>(words_per_line) * 64) {
+                    return -1;
+                }
+                const auto get_word = [&](const long int &word_line, const long int &word) -> std::uint64_t {
+                    if (word_line < 0 || word_line >= line_count || word < 0 || word >= static_cast<long int>(words_per_line)) {
+                        return 0;
+                    }
+                    return bits[word_line * words_per_line + word];
+                };
+                // Where the scan stops: either a jump point, or the first wall
+                long int stop_position = direction > 0 ? words_per_line * 64 : -1;
+                for (long int word = position / 64; word >= 0 && word < static_cast<long int>(words_per_line); word += direction) {
+                    const std::uint64_t current = get_word(line, word), before = get_word(line - 1, word), after = get_word(line + 1, word);
+                    std::uint64_t stops = ~current;
+                    if (direction > 0) {
+                        // Open cells beside the line whose previous cell (in the direction of travel) is a wall
+                        stops |= before & ~(before << 1 | get_word(line - 1, word - 1) >> 63);
+                        stops |= after & ~(after << 1 | get_word(line + 1, word - 1) >> 63);
+                        if (word == position / 64) {
+                            stops &= ~std::uint64_t(0) << (position % 64);
+                        }
+                        if (stops != 0) {
+                            stop_position = word * 64 + __builtin_ctzll(stops);
+                            break;
+                        }
+                    } else {
+                        stops |= before & ~(before >> 1 | get_word(line - 1, word + 1) << 63);
+                        stops |= after & ~(after >> 1 | get_word(line + 1, word + 1) << 63);
+                        if (word == position / 64) {
+                            stops &= ~std::uint64_t(0) >> (63 - position % 64);
+                        }
+                        if (stops != 0) {
+                            stop_position = word * 64 + 63 - __builtin_clzll(stops);
+                            break;
+                        }
+                    }
+                }
+                if (goal_position >= 0 && (direction > 0 ? goal_position >= position && goal_position <= stop_position : goal_position <= position && goal_position >= stop_position)) {
+                    return goal_position;
+                }
+                if (stop_position < 0 || !((get_word(line, stop_position / 64) >> (stop_position % 64)) & 1)) {
+                    return -1;
+                }
+                return stop_position;
+            }
+            /** Travel from a cell in a direction until reaching a jump point (a cell where the path may have to turn), the goal, or a wall
+             * \returns The index of the jump point, or null_index if there is none
+             */
+            std::uint32_t jump(long int col, long int row, const long int &col_dir, const long int &row_dir, const long int &goal_col, const long int &goal_row) const {
+                if (row_dir == 0) {
+                    const long int stop_col = bengine::pathfinder_2d::scan_line(this->walkable_bits, this->words_per_row, this->rows, row, col, col_dir, row == goal_row ? goal_col : -1);
+                    return stop_col < 0 ? bengine::pathfinder_2d::null_index : this->get_index(stop_col, row);
+                }
+                if (col_dir == 0) {
+                    const long int stop_row = bengine::pathfinder_2d::scan_line(this->transposed_bits, this->words_per_col, this->cols, col, row, row_dir, col == goal_col ? goal_row : -1);
+                    return stop_row < 0 ? bengine::pathfinder_2d::null_index : this->get_index(col, stop_row);
+                }
+                while (true) {
+                    if (!this->is_walkable(col, row)) {
+                        return bengine::pathfinder_2d::null_index;
+                    }
+                    if (col == goal_col && row == goal_row) {
+                        return this->get_index(col, row);
+                    }
+                    // A diagonal move stops wherever one of its straight components would find a jump point
+                    if (this->jump(col + col_dir, row, col_dir, 0, goal_col, goal_row) != bengine::pathfinder_2d::null_index || this->jump(col, row + row_dir, 0, row_dir, goal_col, goal_row) != bengine::pathfinder_2d::null_index) {
+                        return this->get_index(col, row);
+                    }
+                    if (!this->is_walkable(col + col_dir, row) || !this->is_walkable(col, row + row_dir)) {
+                        return bengine::pathfinder_2d::null_index;
+                    }
+                    col += col_dir;
+                    row += row_dir;
+                }
+            }
+            // \brief Consider reaching a jump point from the current node
+            void relax(const std::uint32_t &current, const std::uint32_t &next, const long int &goal_col, const long int &goal_row) {
+                bengine::pathfinder_2d::node &next_node = this->nodes[next];
+                if (next_node.generation == this->generation && next_node.is_closed) {
+                    return;
+                }
+                const long int col = next % this->cols, row = next / this->cols;
+                const double g = this->nodes[current].g + bengine::pathfinder_2d::get_octile_distance(current % this->cols, current / this->cols, col, row);
+                if (next_node.generation != this->generation) {
+                    next_node = {g, g + bengine::pathfinder_2d::get_octile_distance(col, row, goal_col, goal_row), current, this->generation, static_cast<std::uint32_t>(this->heap_size), false};
+                    this->heap[this->heap_size++] = next;
+                } else if (g < next_node.g) {
+                    next_node.f -= next_node.g - g;
+                    next_node.g = g;
+                    next_node.parent = current;
+                } else {
+                    return;
+                }
+                this->sift_up(next_node.heap_index);
+            }
+            // \brief Run A* from one cell to another, leaving the jump points of the path in this->jump_points
+            bool search(const long int &start_col, const long int &start_row, const long int &goal_col, const long int &goal_row) {
+                this->searches++;
+                if (++this->generation == 0) {
+                    // Once the stamps wrap around, stale nodes could look current again
+                    for (bengine::pathfinder_2d::node &node : this->nodes) {
+                        node.generation = 0;
+                    }
+                    this->generation = 1;
+                }
+                const std::uint32_t start = this->get_index(start_col, start_row), goal = this->get_index(goal_col, goal_row);
+                this->nodes[start] = {0, bengine::pathfinder_2d::get_octile_distance(start_col, start_row, goal_col, goal_row), start, this->generation, 0, false};
+                this->heap[0] = start;
+                this->heap_size = 1;
+
+                while (this->heap_size > 0) {
+                    const std::uint32_t current = this->pop_heap();
+                    this->nodes[current].is_closed = true;
+                    if (current == goal) {
+                        this->jump_points.clear();
+                        for (std::uint32_t index = goal; index != start; index = this->nodes[index].parent) {
+                            this->jump_points.emplace_back(index);
+                        }
+                        this->jump_points.emplace_back(start);
+                        std::reverse(this->jump_points.begin(), this->jump_points.end());
+                        return true;
+                    }
+
+                    const long int col = current % this->cols, row = current / this->cols;
+                    const auto try_direction = [&](const long int &col_dir, const long int &row_dir) {
+                        const std::uint32_t next = this->jump(col + col_dir, row + row_dir, col_dir, row_dir, goal_col, goal_row);
+                        if (next != bengine::pathfinder_2d::null_index) {
+                            this->relax(current, next, goal_col, goal_row);
+                        }
+                    };
+                    if (current == start) {
+                        for (long int row_dir = -1; row_dir <= 1; row_dir++) {
+                            for (long int col_dir = -1; col_dir <= 1; col_dir++) {
+                                if ((col_dir != 0 || row_dir != 0) && (col_dir == 0 || row_dir == 0 || (this->is_walkable(col + col_dir, row) && this->is_walkable(col, row + row_dir)))) {
+                                    try_direction(col_dir, row_dir);
+                                }
+                            }
+                        }
+                        continue;
+                    }
+
+                    // Only the directions that can't be reached more cheaply through the parent are searched
+                    const long int parent_col = this->nodes[current].parent % this->cols, parent_row = this->nodes[current].parent / this->cols;
+                    const long int col_dir = (col > parent_col) - (col < parent_col), row_dir = (row > parent_row) - (row < parent_row);
+                    if (col_dir != 0 && row_dir != 0) {
+                        const bool col_open = this->is_walkable(col + col_dir, row), row_open = this->is_walkable(col, row + row_dir);
+                        if (row_open) {
+                            try_direction(0, row_dir);
+                        }
+                        if (col_open) {
+                            try_direction(col_dir, 0);
+                        }
+                        if (col_open && row_open) {
+                            try_direction(col_dir, row_dir);
+                        }
+                    } else if (col_dir != 0) {
+                        const bool ahead_open = this->is_walkable(col + col_dir, row), up_open = this->is_walkable(col, row - 1), down_open = this->is_walkable(col, row + 1);
+                        if (ahead_open) {
+                            try_direction(col_dir, 0);
+                            if (up_open) {
+                                try_direction(col_dir, -1);
+                            }
+                            if (down_open) {
+                                try_direction(col_dir, 1);
+                            }
+                        }
+                        if (up_open) {
+                            try_direction(0, -1);
+                        }
+                        if (down_open) {
+                            try_direction(0, 1);
+                        }
+                    } else {
+                        const bool ahead_open = this->is_walkable(col, row + row_dir), left_open = this->is_walkable(col - 1, row), right_open = this->is_walkable(col + 1, row);
+                        if (ahead_open) {
+                            try_direction(0, row_dir);
+                            if (left_open) {
+                                try_direction(-1, row_dir);
+                            }
+                            if (right_open) {
+                                try_direction(1, row_dir);
+                            }
+                        }
+                        if (left_open) {
+                            try_direction(-1, 0);
+                        }
+                        if (right_open) {
+                            try_direction(1, 0);
+                        }
+                    }
+                }
+                return false;
+            }
+
+            /** Check whether an agent can walk straight between two points, by casting rays down the middle and both sides of the line
+             * \returns Whether no wall is in the way
+             */
+            bool is_clear(const bengine::coordinate_2d<double> &from, const bengine::coordinate_2d<double> &to) const {
+                const double x_difference = to.get_x_pos() - from.get_x_pos(), y_difference = to.get_y_pos() - from.get_y_pos();
+                const double distance = std::sqrt(x_difference * x_difference + y_difference * y_difference);
+                if (distance == 0) {
+                    return true;
+                }
+                const double angle = std::atan2(y_difference, x_difference);
+                const double x_offset = -y_difference / distance * this->clearance, y_offset = x_difference / distance * this->clearance;
+                for (char side = -1; side <= 1; side++) {
+                    if (this->grid->cast_ray(from.get_x_pos() + x_offset * side, from.get_y_pos() + y_offset * side, angle, distance).has_value()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            /** Write the last path found to an output, skipping any waypoints that can be seen past
+             * \param start The exact start position
+             * \param goal The exact goal position
+             * \param path The output (waypoints after the start, ending with the goal)
+             */
+            void smooth_path(const bengine::coordinate_2d<double> &start, const bengine::coordinate_2d<double> &goal, std::vector<bengine::coordinate_2d<double>> &path) {
+                this->raw_path.clear();
+                this->raw_path.emplace_back(start);
+                for (std::size_t i = 1; i + 1 < this->jump_points.size(); i++) {
+                    this->raw_path.emplace_back(this->jump_points[i] % this->cols + 0.5, this->jump_points[i] / this->cols + 0.5);
+                }
+                this->raw_path.emplace_back(goal);
+
+                path.clear();
+                bengine::coordinate_2d<double> anchor = start;
+                for (std::size_t i = 1; i + 1 < this->raw_path.size(); i++) {
+                    if (!this->is_clear(anchor, this->raw_path[i + 1])) {
+                        path.emplace_back(this->raw_path[i]);
+                        anchor = this->raw_path[i];
+                    }
+                }
+                path.emplace_back(goal);
+            }
+
+            std::uint64_t get_cache_key(const long int &start_col, const long int &start_row, const long int &goal_col, const long int &goal_row) const {
+                const std::uint64_t regions_per_row = (this->cols + this->region_size - 1) / this->region_size;
+                const std::uint64_t start_region = start_row / this->region_size * regions_per_row + start_col / this->region_size;
+                const std::uint64_t goal_region = goal_row / this->region_size * regions_per_row + goal_col / this->region_size;
+                return start_region << 32 | goal_region;
+            }
+            bengine::pathfinder_2d::cache_slot &get_cache_slot(const std::uint64_t &key) {
+                // Keys are mixed (splitmix64) so that nearby regions spread across the slots
+                std::uint64_t hash = key + 0x9e3779b97f4a7c15ull;
+                hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+                hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+                return this->cache_slots[(hash ^ (hash >> 31)) % this->cache_slots.size()];
+            }
+            /** Try to reuse a cached path between the same regions, which only works if the exact start/goal can see the two ends of it
+             * \returns Whether the cached path was used
+             */
+            bool use_cached_path(const std::uint64_t &key, const bengine::coordinate_2d<double> &start, const bengine::coordinate_2d<double> &goal, std::vector<bengine::coordinate_2d<double>> &path) {
+                const bengine::pathfinder_2d::cache_slot &slot = this->get_cache_slot(key);
+                if (slot.version != this->cache_version || slot.key != key) {
+                    return false;
+                }
+                const bengine::coordinate_2d<double> &first = slot.count > 0 ? this->cache_points[slot.offset] : goal;
+                const bengine::coordinate_2d<double> &last = slot.count > 0 ? this->cache_points[slot.offset + slot.count - 1] : start;
+                if (!this->is_clear(start, first) || (slot.count > 0 && !this->is_clear(last, goal))) {
+                    return false;
+                }
+                path.assign(this->cache_points.begin() + slot.offset, this->cache_points.begin() + slot.offset + slot.count);
+                path.emplace_back(goal);
+                this->cache_hits++;
+                return true;
+            }
+            // \brief Cache a path's waypoints (minus the goal, which is different for every agent)
+            void cache_path(const std::uint64_t &key, const std::vector<bengine::coordinate_2d<double>> &path) {
+                const std::size_t count = path.size() - 1;
+                if (this->cache_points.size() + count > this->cache_points.capacity()) {
+                    // The pool is full, so everything cached so far is thrown away (without reallocating)
+                    this->cache_points.clear();
+                    this->cache_version++;
+                }
+                if (count > this->cache_points.capacity()) {
+                    return;
+                }
+                bengine::pathfinder_2d::cache_slot &slot = this->get_cache_slot(key);
+                slot = {key, this->cache_version, static_cast<std::uint32_t>(this->cache_points.size()), static_cast<std::uint32_t>(count)};
+                this->cache_points.insert(this->cache_points.end(), path.begin(), path.end() - 1);
+            }
+
+        public:
+            /** Create a pathfinder
+             * \param region_size The side length of the square regions (in cells) that paths are cached by; agents starting and ending in the same regions share paths
+             * \param cache_size How many paths can be cached at once
+             * \param clearance How far smoothed paths stay from walls (should be about the radius of the agents following them, and is capped just under half a cell)
+             */
+            pathfinder_2d(const std::size_t &region_size = 8, const std::size_t &cache_size = 4096, const double &clearance = 0.25) {
+                this->region_size = std::max<std::size_t>(region_size, 1);
+                this->cache_slots.assign(std::max<std::size_t>(cache_size, 1), {0, 0, 0, 0});
+                this->cache_points.reserve(this->cache_slots.size() * 16);
+                this->clearance = std::min(clearance, 0.49);
+            }
+
+            /** Copy the walls of a grid (needed before any paths can be found, and again if the grid is resized)
+             * \param grid The grid (must outlive the pathfinder)
+             */
+            void load(const bengine::grid_2d &grid) {
+                this->grid = &grid;
+                this->cols = grid.get_cols();
+                this->rows = grid.get_rows();
+                this->words_per_row = (this->cols + 63) / 64;
+                this->words_per_col = (this->rows + 63) / 64;
+                this->walkable_bits.assign(this->words_per_row * this->rows, 0);
+                this->transposed_bits.assign(this->words_per_col * this->cols, 0);
+                for (long int row = 0; row < this->rows; row++) {
+                    for (long int col = 0; col < this->cols; col++) {
+                        if (!grid.is_solid(col, row)) {
+                            this->walkable_bits[row * this->words_per_row + col / 64] |= std::uint64_t(1) << (col % 64);
+                            this->transposed_bits[col * this->words_per_col + row / 64] |= std::uint64_t(1) << (row % 64);
+                        }
+                    }
+                }
+                this->nodes.assign(this->cols * this->rows, {0, 0, 0, 0, 0, false});
+                this->heap.resize(this->cols * this->rows);
+                this->generation = 0;
+                this->cache_points.clear();
+                this->cache_version++;
+            }
+            /** Update a cell after it has been edited (every cached path is thrown away, since any of them could go through the cell)
+             * \param col The column of the edited cell
+             * \param row The row of the edited cell
+             */
+            void refresh_cell(const std::size_t &col, const std::size_t &row) {
+                if (static_cast<long int>(col) >= this->cols || static_cast<long int>(row) >= this->rows) {
+                    return;
+                }
+                const bool is_solid = this->grid->is_solid(col, row);
+                std::uint64_t &word = this->walkable_bits[row * this->words_per_row + col / 64], &transposed_word = this->transposed_bits[col * this->words_per_col + row / 64];
+                word = is_solid ? word & ~(std::uint64_t(1) << (col % 64)) : word | std::uint64_t(1) << (col % 64);
+                transposed_word = is_solid ? transposed_word & ~(std::uint64_t(1) << (row % 64)) : transposed_word | std::uint64_t(1) << (row % 64);
+                this->cache_points.clear();
+                this->cache_version++;
+            }
+
+            double get_clearance() const {
+                return this->clearance;
+            }
+            void set_clearance(const double &clearance) {
+                this->clearance = std::min(clearance, 0.49);
+                this->cache_points.clear();
+                this->cache_version++;
+            }
+            // \brief Get how many paths have been taken from the cache
+            std::size_t get_cache_hits() const {
+                return this->cache_hits;
+            }
+            // \brief Get how many paths have had to be searched for
+            std::size_t get_search_count() const {
+                return this->searches;
+            }
+
+            /** Find a path between two points
+             * \param start_x The x-position to start at
+             * \param start_y The y-position to start at
+             * \param goal_x The x-position to go to
+             * \param goal_y The y-position to go to
+             * \param path The output, which is filled with the waypoints after the start (ending with the goal); reusing the same vector between calls avoids allocating
+             * \param use_cache Whether a cached path between the same regions can be used (and whether a newly found path is cached)
+             * \returns Whether a path was found (the output is left empty if not)
+             */
+            bool find_path(const double &start_x, const double &start_y, const double &goal_x, const double &goal_y, std::vector<bengine::coordinate_2d<double>> &path, const bool &use_cache = true) {
+                path.clear();
+                const long int start_col = std::floor(start_x), start_row = std::floor(start_y), goal_col = std::floor(goal_x), goal_row = std::floor(goal_y);
+                if (!this->is_walkable(start_col, start_row) || !this->is_walkable(goal_col, goal_row)) {
+                    return false;
+                }
+                const bengine::coordinate_2d<double> start(start_x, start_y), goal(goal_x, goal_y);
+                if (start_col == goal_col && start_row == goal_row) {
+                    path.emplace_back(goal);
+                    return true;
+                }
+
+                const std::uint64_t key = this->get_cache_key(start_col, start_row, goal_col, goal_row);
+                // Paths within a single region are quick to find, and too specific to be worth sharing
+                const bool is_cacheable = use_cache && key >> 32 != (key & UINT32_MAX);
+                if (is_cacheable && this->use_cached_path(key, start, goal, path)) {
+                    return true;
+                }
+                if (!this->search(start_col, start_row, goal_col, goal_row)) {
+                    return false;
+                }
+                this->smooth_path(start, goal, path);
+                if (is_cacheable) {
+                    this->cache_path(key, path);
+                }
+                return true;
+            }
+    };
+}
+
+#endif // BENGINE_PATHFINDING_hpp
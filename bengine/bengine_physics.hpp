@@ -1,7 +1,18 @@
 #ifndef BENGINE_PHYSICS_hpp
 #define BENGINE_PHYSICS_hpp
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "bengine_colliders.hpp"
+#include "bengine_spatial_hash.hpp"
+#include "bengine_worker_pool.hpp"
+
 namespace bengine {
+    // \brief The state of a single body; used to add bodies to/read bodies from a bengine::physics_world_2d, which stores everything itself
     class physics_object_2d {
         protected:
             double x_pos = 0;
@@ -15,9 +26,542 @@ namespace bengine {
             double y_frc = 0;
 
             double mass = 1;
-        
+
+            // \brief Half of the width of the body's collider (a body with no width/height has no collider)
+            double width_2 = 0;
+            // \brief Half of the height of the body's collider (a body with no width/height has no collider)
+            double height_2 = 0;
+
         public:
             physics_object_2d() {}
+            physics_object_2d(const double &x_pos, const double &y_pos, const double &width, const double &height, const double &mass = 1) {
+                this->set_x_pos(x_pos);
+                this->set_y_pos(y_pos);
+                this->set_width(width);
+                this->set_height(height);
+                this->set_mass(mass);
+            }
+
+            double get_x_pos() const {
+                return this->x_pos;
+            }
+            double get_y_pos() const {
+                return this->y_pos;
+            }
+            double get_x_vel() const {
+                return this->x_vel;
+            }
+            double get_y_vel() const {
+                return this->y_vel;
+            }
+            double get_x_acl() const {
+                return this->x_acl;
+            }
+            double get_y_acl() const {
+                return this->y_acl;
+            }
+            double get_x_frc() const {
+                return this->x_frc;
+            }
+            double get_y_frc() const {
+                return this->y_frc;
+            }
+            double get_mass() const {
+                return this->mass;
+            }
+            double get_width() const {
+                return this->width_2 + this->width_2;
+            }
+            double get_height() const {
+                return this->height_2 + this->height_2;
+            }
+
+            void set_x_pos(const double &x_pos) {
+                this->x_pos = x_pos;
+            }
+            void set_y_pos(const double &y_pos) {
+                this->y_pos = y_pos;
+            }
+            void set_x_vel(const double &x_vel) {
+                this->x_vel = x_vel;
+            }
+            void set_y_vel(const double &y_vel) {
+                this->y_vel = y_vel;
+            }
+            void set_x_acl(const double &x_acl) {
+                this->x_acl = x_acl;
+            }
+            void set_y_acl(const double &y_acl) {
+                this->y_acl = y_acl;
+            }
+            void set_x_frc(const double &x_frc) {
+                this->x_frc = x_frc;
+            }
+            void set_y_frc(const double &y_frc) {
+                this->y_frc = y_frc;
+            }
+            /** Set the mass of the body
+             * \param mass The new mass (anything less than or equal to 0 is treated as infinite, so forces won't affect the body)
+             */
+            void set_mass(const double &mass) {
+                this->mass = mass;
+            }
+            void set_width(const double &width) {
+                this->width_2 = std::fabs(width) / 2;
+            }
+            void set_height(const double &height) {
+                this->height_2 = std::fabs(height) / 2;
+            }
+
+            bool has_collider() const {
+                return this->width_2 > 0 && this->height_2 > 0;
+            }
+            bengine::basic_collider_2d get_collider() const {
+                return bengine::basic_collider_2d(this->x_pos, this->y_pos, this->get_width(), this->get_height());
+            }
+    };
+
+    /** A collection of bodies stored as a structure of arrays, meant to be the backend for anything that moves on its own (NPCs, projectiles, etc)
+     *
+     * Each property is kept in its own contiguous array, so stepping the world is a handful of straight loops over doubles that the compiler can vectorize
+     * Bodies are referred to through the IDs handed out when they are added; internally bodies get moved around (removal swaps the last body into the gap), so indices should never be held onto
+     */
+    class physics_world_2d {
+        private:
+            std::vector<double> x_pos;
+            std::vector<double> y_pos;
+            std::vector<double> x_vel;
+            std::vector<double> y_vel;
+            std::vector<double> x_acl;
+            std::vector<double> y_acl;
+            std::vector<double> x_frc;
+            std::vector<double> y_frc;
+            // \brief 1 / mass, which makes infinite mass (0) and force application cheap
+            std::vector<double> inverse_mass;
+            std::vector<double> width_2;
+            std::vector<double> height_2;
+            // \brief The ID of each body in bengine::physics_world_2d::body_hash (only meaningful for bodies with colliders)
+            std::vector<std::size_t> hash_ids;
+
+            // \brief The ID that each body index belongs to
+            std::vector<std::size_t> index_to_id;
+            // \brief The index that each ID currently refers to (bengine::physics_world_2d::invalid_index if the ID is unused)
+            std::vector<std::size_t> id_to_index;
+            std::vector<std::size_t> free_ids;
+            // \brief The body ID that each bengine::physics_world_2d::body_hash entry belongs to
+            std::vector<std::size_t> hash_id_to_id;
+            static constexpr std::size_t invalid_index = __SIZE_MAX__;
+
+            // \brief Broadphase holding every body that has a collider
+            bengine::spatial_hash_2d body_hash = bengine::spatial_hash_2d(2);
+            // \brief Static level geometry that bodies can't move through (optional)
+            const bengine::spatial_hash_2d *static_colliders = nullptr;
+            // \brief Threads used to resolve contacts between bodies (optional)
+            bengine::worker_pool *workers = nullptr;
+            // \brief How many times each island's contacts are resolved per step (later fixes can create new overlaps, so a few passes are needed for stacks/crowds)
+            unsigned char contact_iterations = 4;
+
+            // \brief Pairs of overlapping body indices (first < second) found during the current step
+            std::vector<std::pair<std::size_t, std::size_t>> contacts;
+            // \brief Union-find parents used to group bodies into islands
+            std::vector<std::size_t> island_parents;
+            // \brief The contacts of every island, stored back to back (see bengine::physics_world_2d::island_offsets)
+            std::vector<std::size_t> island_contacts;
+            // \brief Where each island's contacts start in bengine::physics_world_2d::island_contacts (one extra entry marks the end of the last island)
+            std::vector<std::size_t> island_offsets;
+            std::vector<std::size_t> nearby_hash_ids;
+
+            std::size_t find_island(const std::size_t &index) {
+                std::size_t root = index;
+                while (this->island_parents[root] != root) {
+                    root = this->island_parents[root];
+                }
+                // Path compression keeps later lookups short
+                std::size_t current = index;
+                while (this->island_parents[current] != root) {
+                    const std::size_t next = this->island_parents[current];
+                    this->island_parents[current] = root;
+                    current = next;
+                }
+                return root;
+            }
+            void join_islands(const std::size_t &index_1, const std::size_t &index_2) {
+                const std::size_t root_1 = this->find_island(index_1);
+                const std::size_t root_2 = this->find_island(index_2);
+                // The smaller index always becomes the root so that island roots (and therefore island order) never depend on the order of joins
+                if (root_1 < root_2) {
+                    this->island_parents[root_2] = root_1;
+                } else if (root_2 < root_1) {
+                    this->island_parents[root_1] = root_2;
+                }
+            }
+            /** Resolve a single contact using bengine::basic_collider_2d::fix_collision; the fix mode is picked from the masses of the bodies (bodies with infinite mass never move)
+             * \param contact The index of the contact in bengine::physics_world_2d::contacts
+             */
+            void resolve_contact(const std::size_t &contact) {
+                const std::size_t index_1 = this->contacts[contact].first;
+                const std::size_t index_2 = this->contacts[contact].second;
+                bengine::basic_collider_2d::fix_mode mode;
+                if (this->inverse_mass[index_1] == 0 && this->inverse_mass[index_2] == 0) {
+                    return;
+                } else if (this->inverse_mass[index_1] == 0) {
+                    mode = bengine::basic_collider_2d::fix_mode::MOVE_OTHER;
+                } else if (this->inverse_mass[index_2] == 0) {
+                    mode = bengine::basic_collider_2d::fix_mode::MOVE_SELF;
+                } else {
+                    mode = bengine::basic_collider_2d::fix_mode::MOVE_BOTH;
+                }
+
+                bengine::basic_collider_2d collider_1 = this->get_collider_at(index_1);
+                bengine::basic_collider_2d collider_2 = this->get_collider_at(index_2);
+                // Bodies with infinite mass are only read; they can touch several islands at once, so writing them back (even unchanged) would race with the other islands' threads
+                if (collider_1.fix_collision(collider_2, mode, true)) {
+                    if (this->inverse_mass[index_1] != 0) {
+                        this->x_pos[index_1] = collider_1.get_x_pos();
+                        this->y_pos[index_1] = collider_1.get_y_pos();
+                    }
+                    if (this->inverse_mass[index_2] != 0) {
+                        this->x_pos[index_2] = collider_2.get_x_pos();
+                        this->y_pos[index_2] = collider_2.get_y_pos();
+                    }
+                }
+            }
+
+            std::size_t get_index(const std::size_t &id) const {
+                return this->id_to_index.at(id);
+            }
+            bengine::basic_collider_2d get_collider_at(const std::size_t &index) const {
+                return bengine::basic_collider_2d(this->x_pos[index], this->y_pos[index], this->width_2[index] * 2, this->height_2[index] * 2);
+            }
+            bool has_collider_at(const std::size_t &index) const {
+                return this->width_2[index] > 0 && this->height_2[index] > 0;
+            }
+
+        public:
+            physics_world_2d() {}
+
+            // \brief Get the amount of bodies in the world
+            std::size_t get_size() const {
+                return this->x_pos.size();
+            }
+            bool contains(const std::size_t &id) const {
+                return id < this->id_to_index.size() && this->id_to_index[id] != bengine::physics_world_2d::invalid_index;
+            }
+            // \brief Get the broadphase holding every body that has a collider (IDs in it are not body IDs, see bengine::physics_world_2d::get_body_from_hash_id)
+            const bengine::spatial_hash_2d &get_body_hash() const {
+                return this->body_hash;
+            }
+            /** Set the static level geometry that bodies collide with
+             * \param static_colliders A broadphase holding the level geometry (must outlive the world or be reset), or nullptr to let bodies move freely
+             */
+            void set_static_colliders(const bengine::spatial_hash_2d *static_colliders) {
+                this->static_colliders = static_colliders;
+            }
+            /** Set the threads used to resolve contacts between bodies; results are identical no matter how many threads there are
+             * \param workers The threads to use (must outlive the world or be reset), or nullptr to resolve everything on the calling thread
+             */
+            void set_worker_pool(bengine::worker_pool *workers) {
+                this->workers = workers;
+            }
+            unsigned char get_contact_iterations() const {
+                return this->contact_iterations;
+            }
+            void set_contact_iterations(const unsigned char &iterations) {
+                this->contact_iterations = iterations;
+            }
+
+            /** Add a body to the world
+             * \param body The initial state of the body
+             * \returns The ID that the body can be referred to with from now on
+             */
+            std::size_t add_body(const bengine::physics_object_2d &body) {
+                std::size_t id;
+                if (this->free_ids.empty()) {
+                    id = this->id_to_index.size();
+                    this->id_to_index.emplace_back();
+                } else {
+                    id = this->free_ids.back();
+                    this->free_ids.pop_back();
+                }
+                this->id_to_index[id] = this->x_pos.size();
+                this->index_to_id.emplace_back(id);
+
+                this->x_pos.emplace_back(body.get_x_pos());
+                this->y_pos.emplace_back(body.get_y_pos());
+                this->x_vel.emplace_back(body.get_x_vel());
+                this->y_vel.emplace_back(body.get_y_vel());
+                this->x_acl.emplace_back(body.get_x_acl());
+                this->y_acl.emplace_back(body.get_y_acl());
+                this->x_frc.emplace_back(body.get_x_frc());
+                this->y_frc.emplace_back(body.get_y_frc());
+                this->inverse_mass.emplace_back(body.get_mass() <= 0 ? 0 : 1 / body.get_mass());
+                this->width_2.emplace_back(body.get_width() / 2);
+                this->height_2.emplace_back(body.get_height() / 2);
+                this->hash_ids.emplace_back(0);
+                if (body.has_collider()) {
+                    this->hash_ids.back() = this->body_hash.insert(body.get_collider(), false);
+                    if (this->hash_ids.back() >= this->hash_id_to_id.size()) {
+                        this->hash_id_to_id.resize(this->hash_ids.back() + 1, bengine::physics_world_2d::invalid_index);
+                    }
+                    this->hash_id_to_id[this->hash_ids.back()] = id;
+                }
+                return id;
+            }
+            /** Remove a body from the world (its ID may be handed out again by a later addition)
+             * \param id The ID of the body
+             */
+            void remove_body(const std::size_t &id) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                const std::size_t index = this->get_index(id);
+                const std::size_t last = this->x_pos.size() - 1;
+                if (this->has_collider_at(index)) {
+                    this->body_hash.remove(this->hash_ids[index]);
+                    this->hash_id_to_id[this->hash_ids[index]] = bengine::physics_world_2d::invalid_index;
+                }
+
+                // The last body is moved into the gap so that the arrays stay packed
+                this->x_pos[index] = this->x_pos[last];
+                this->y_pos[index] = this->y_pos[last];
+                this->x_vel[index] = this->x_vel[last];
+                this->y_vel[index] = this->y_vel[last];
+                this->x_acl[index] = this->x_acl[last];
+                this->y_acl[index] = this->y_acl[last];
+                this->x_frc[index] = this->x_frc[last];
+                this->y_frc[index] = this->y_frc[last];
+                this->inverse_mass[index] = this->inverse_mass[last];
+                this->width_2[index] = this->width_2[last];
+                this->height_2[index] = this->height_2[last];
+                this->hash_ids[index] = this->hash_ids[last];
+                this->index_to_id[index] = this->index_to_id[last];
+                this->id_to_index[this->index_to_id[index]] = index;
+
+                this->x_pos.pop_back();
+                this->y_pos.pop_back();
+                this->x_vel.pop_back();
+                this->y_vel.pop_back();
+                this->x_acl.pop_back();
+                this->y_acl.pop_back();
+                this->x_frc.pop_back();
+                this->y_frc.pop_back();
+                this->inverse_mass.pop_back();
+                this->width_2.pop_back();
+                this->height_2.pop_back();
+                this->hash_ids.pop_back();
+                this->index_to_id.pop_back();
+
+                this->id_to_index[id] = bengine::physics_world_2d::invalid_index;
+                this->free_ids.emplace_back(id);
+            }
+            /** Get a copy of a body's current state
+             * \param id The ID of the body
+             * \returns A bengine::physics_object_2d holding the body's state
+             */
+            bengine::physics_object_2d get_body(const std::size_t &id) const {
+                const std::size_t index = this->get_index(id);
+                bengine::physics_object_2d output(this->x_pos[index], this->y_pos[index], this->width_2[index] * 2, this->height_2[index] * 2, this->inverse_mass[index] == 0 ? 0 : 1 / this->inverse_mass[index]);
+                output.set_x_vel(this->x_vel[index]);
+                output.set_y_vel(this->y_vel[index]);
+                output.set_x_acl(this->x_acl[index]);
+                output.set_y_acl(this->y_acl[index]);
+                output.set_x_frc(this->x_frc[index]);
+                output.set_y_frc(this->y_frc[index]);
+                return output;
+            }
+            /** Find which body a broadphase entry belongs to
+             * \param hash_id The ID of the entry in bengine::physics_world_2d::get_body_hash
+             * \returns The ID of the body, or std::nullopt if no body owns the entry
+             */
+            std::optional<std::size_t> get_body_from_hash_id(const std::size_t &hash_id) const {
+                if (hash_id >= this->hash_id_to_id.size() || this->hash_id_to_id[hash_id] == bengine::physics_world_2d::invalid_index) {
+                    return std::nullopt;
+                }
+                return this->hash_id_to_id[hash_id];
+            }
+
+            double get_x_pos(const std::size_t &id) const {
+                return this->x_pos[this->get_index(id)];
+            }
+            double get_y_pos(const std::size_t &id) const {
+                return this->y_pos[this->get_index(id)];
+            }
+            double get_x_vel(const std::size_t &id) const {
+                return this->x_vel[this->get_index(id)];
+            }
+            double get_y_vel(const std::size_t &id) const {
+                return this->y_vel[this->get_index(id)];
+            }
+            /** Teleport a body (bypasses collision)
+             * \param id The ID of the body
+             * \param x_pos The new x-position
+             * \param y_pos The new y-position
+             */
+            void set_position(const std::size_t &id, const double &x_pos, const double &y_pos) {
+                const std::size_t index = this->get_index(id);
+                this->x_pos[index] = x_pos;
+                this->y_pos[index] = y_pos;
+                if (this->has_collider_at(index)) {
+                    this->body_hash.update(this->hash_ids[index], this->get_collider_at(index));
+                }
+            }
+            void set_velocity(const std::size_t &id, const double &x_vel, const double &y_vel) {
+                const std::size_t index = this->get_index(id);
+                this->x_vel[index] = x_vel;
+                this->y_vel[index] = y_vel;
+            }
+            void set_acceleration(const std::size_t &id, const double &x_acl, const double &y_acl) {
+                const std::size_t index = this->get_index(id);
+                this->x_acl[index] = x_acl;
+                this->y_acl[index] = y_acl;
+            }
+            /** Add a force to a body for the next step only (forces are cleared after every step)
+             * \param id The ID of the body
+             * \param x_frc The horizontal component of the force
+             * \param y_frc The vertical component of the force
+             */
+            void apply_force(const std::size_t &id, const double &x_frc, const double &y_frc) {
+                const std::size_t index = this->get_index(id);
+                this->x_frc[index] += x_frc;
+                this->y_frc[index] += y_frc;
+            }
+
+            /** Advance every body by one step using semi-implicit Euler integration (velocity first, then position with the new velocity)
+             * \param delta_time How much time the step covers
+             */
+            void step(const double &delta_time) {
+                const std::size_t size = this->x_pos.size();
+                double *__restrict x_vel = this->x_vel.data();
+                double *__restrict y_vel = this->y_vel.data();
+                double *__restrict x_frc = this->x_frc.data();
+                double *__restrict y_frc = this->y_frc.data();
+                const double *__restrict x_acl = this->x_acl.data();
+                const double *__restrict y_acl = this->y_acl.data();
+                const double *__restrict inverse_mass = this->inverse_mass.data();
+
+                for (std::size_t i = 0; i < size; i++) {
+                    x_vel[i] += (x_acl[i] + x_frc[i] * inverse_mass[i]) * delta_time;
+                    y_vel[i] += (y_acl[i] + y_frc[i] * inverse_mass[i]) * delta_time;
+                    x_frc[i] = 0;
+                    y_frc[i] = 0;
+                }
+
+                if (this->static_colliders == nullptr) {
+                    double *__restrict x_pos = this->x_pos.data();
+                    double *__restrict y_pos = this->y_pos.data();
+                    for (std::size_t i = 0; i < size; i++) {
+                        x_pos[i] += x_vel[i] * delta_time;
+                        y_pos[i] += y_vel[i] * delta_time;
+                    }
+                } else {
+                    // Bodies with colliders are swept against the level; whatever velocity is lost to the level (moving into a wall) is dropped so that bodies slide instead of building up speed
+                    for (std::size_t i = 0; i < size; i++) {
+                        if (!this->has_collider_at(i) || (x_vel[i] == 0 && y_vel[i] == 0)) {
+                            this->x_pos[i] += x_vel[i] * delta_time;
+                            this->y_pos[i] += y_vel[i] * delta_time;
+                            continue;
+                        }
+                        bengine::basic_collider_2d collider = this->get_collider_at(i);
+                        if (this->static_colliders->move_and_slide(collider, x_vel[i] * delta_time, y_vel[i] * delta_time)) {
+                            x_vel[i] = (collider.get_x_pos() - this->x_pos[i]) / delta_time;
+                            y_vel[i] = (collider.get_y_pos() - this->y_pos[i]) / delta_time;
+                        }
+                        this->x_pos[i] = collider.get_x_pos();
+                        this->y_pos[i] = collider.get_y_pos();
+                    }
+                }
+
+                for (std::size_t i = 0; i < size; i++) {
+                    if (this->has_collider_at(i)) {
+                        this->body_hash.update(this->hash_ids[i], this->get_collider_at(i));
+                    }
+                }
+
+                this->solve_contacts();
+            }
+
+            /** Push apart every pair of overlapping bodies
+             *
+             * Contacts are split into islands (groups of bodies that touch each other, directly or through other bodies) which are resolved independently, possibly in parallel
+             * Every island is resolved in a fixed order by a single thread and islands never share a movable body, so the results are bit-identical regardless of how many threads are used
+             */
+            void solve_contacts() {
+                const std::size_t size = this->x_pos.size();
+
+                // Gather contacts in index order (first < second), with each body's contacts ordered by their broadphase ID
+                this->contacts.clear();
+                for (std::size_t i = 0; i < size; i++) {
+                    if (!this->has_collider_at(i) || this->inverse_mass[i] == 0) {
+                        continue;
+                    }
+                    this->nearby_hash_ids.clear();
+                    this->body_hash.query_aabb(this->get_collider_at(i), this->nearby_hash_ids);
+                    for (const std::size_t &hash_id : this->nearby_hash_ids) {
+                        const std::size_t other = this->id_to_index[this->hash_id_to_id[hash_id]];
+                        // Pairs of movable bodies are seen from both sides, so only one side keeps them
+                        if (other == i || (other < i && this->inverse_mass[other] != 0)) {
+                            continue;
+                        }
+                        this->contacts.emplace_back(std::min(i, other), std::max(i, other));
+                    }
+                }
+                if (this->contacts.empty()) {
+                    return;
+                }
+
+                // Bodies with infinite mass never move, so they don't link the islands of the bodies resting against them
+                this->island_parents.resize(size);
+                for (std::size_t i = 0; i < size; i++) {
+                    this->island_parents[i] = i;
+                }
+                for (const std::pair<std::size_t, std::size_t> &contact : this->contacts) {
+                    if (this->inverse_mass[contact.first] != 0 && this->inverse_mass[contact.second] != 0) {
+                        this->join_islands(contact.first, contact.second);
+                    }
+                }
+
+                // Counting sort of the contacts by island root; being stable, each island keeps the gathering order of its contacts
+                std::vector<std::size_t> contact_islands(this->contacts.size());
+                std::vector<std::size_t> island_sizes(size + 1, 0);
+                for (std::size_t i = 0; i < this->contacts.size(); i++) {
+                    contact_islands[i] = this->find_island(this->inverse_mass[this->contacts[i].first] != 0 ? this->contacts[i].first : this->contacts[i].second);
+                    island_sizes[contact_islands[i] + 1]++;
+                }
+                this->island_offsets.clear();
+                this->island_offsets.emplace_back(0);
+                std::vector<std::size_t> island_starts(size + 1, 0);
+                for (std::size_t root = 0; root < size; root++) {
+                    island_starts[root + 1] = island_starts[root] + island_sizes[root + 1];
+                    if (island_sizes[root + 1] > 0) {
+                        this->island_offsets.emplace_back(island_starts[root + 1]);
+                    }
+                }
+                this->island_contacts.resize(this->contacts.size());
+                for (std::size_t i = 0; i < this->contacts.size(); i++) {
+                    this->island_contacts[island_starts[contact_islands[i]]++] = i;
+                }
+
+                const std::function<void(const std::size_t &)> solve_island = [&](const std::size_t &island) {
+                    for (unsigned char iteration = 0; iteration < this->contact_iterations; iteration++) {
+                        for (std::size_t i = this->island_offsets[island]; i < this->island_offsets[island + 1]; i++) {
+                            this->resolve_contact(this->island_contacts[i]);
+                        }
+                    }
+                };
+                if (this->workers == nullptr) {
+                    for (std::size_t island = 0; island + 1 < this->island_offsets.size(); island++) {
+                        solve_island(island);
+                    }
+                } else {
+                    this->workers->run(this->island_offsets.size() - 1, solve_island);
+                }
+
+                for (std::size_t i = 0; i < size; i++) {
+                    if (this->has_collider_at(i)) {
+                        this->body_hash.update(this->hash_ids[i], this->get_collider_at(i));
+                    }
+                }
+            }
     };
 }
 
@@ -0,0 +1,133 @@
+#ifndef BENGINE_RAY_FAN_hpp
+#define BENGINE_RAY_FAN_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "bengine_render_window.hpp"
+
+namespace bengine {
+    /** A fan of rays (e.g. the view cone of a raycaster drawn onto a minimap), rendered as one filled mesh instead of a line per ray
+     *
+     * Neighboring rays usually end on the same wall, so the fan can be decimated down to the points where its edge actually bends before rendering
+     */
+    class ray_fan_2d {
+        private:
+            // \brief The center of the fan followed by the end of every ray in order
+            std::vector<SDL_Vertex> vertices;
+
+            // \brief Scratch space for decimation (links between the points that are left, and how much removing each one would change the fan)
+            std::vector<std::size_t> previous;
+            std::vector<std::size_t> next;
+            std::vector<double> costs;
+            std::vector<bool> removed;
+            std::priority_queue<std::pair<double, std::size_t>, std::vector<std::pair<double, std::size_t>>, std::greater<std::pair<double, std::size_t>>> queue;
+
+            /** Get how much removing a point would change the fan; this is the area of the triangle it makes with its neighbors, or __DBL_MAX__ if its color differs from either of them (so that edges between colors stay put)
+             * \param point The index of the vertex
+             */
+            double get_cost(const std::size_t &point) const {
+                const SDL_Vertex &a = this->vertices[this->previous[point]], &b = this->vertices[point], &c = this->vertices[this->next[point]];
+                const auto is_same_color = [](const SDL_Color &lhs, const SDL_Color &rhs) {
+                    return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+                };
+                if (!is_same_color(a.color, b.color) || !is_same_color(b.color, c.color)) {
+                    return __DBL_MAX__;
+                }
+                return std::fabs((b.position.x - a.position.x) * (c.position.y - a.position.y) - (c.position.x - a.position.x) * (b.position.y - a.position.y)) / 2;
+            }
+
+        public:
+            ray_fan_2d() {}
+
+            /** Start a new fan, removing every ray
+             * \param x_pos The x-position of the center of the fan relative to the window (px)
+             * \param y_pos The y-position of the center of the fan relative to the window (px)
+             * \param color The color at the center of the fan
+             */
+            void begin(const double &x_pos, const double &y_pos, const SDL_Color &color) {
+                this->vertices.clear();
+                this->vertices.push_back({{static_cast<float>(x_pos), static_cast<float>(y_pos)}, color, {0, 0}});
+            }
+            /** Add a ray going from the center of the fan to a point (rays must be added in order of angle)
+             * \param x_pos The x-position of the end of the ray relative to the window (px)
+             * \param y_pos The y-position of the end of the ray relative to the window (px)
+             * \param color The color at the end of the ray
+             */
+            void add_ray(const double &x_pos, const double &y_pos, const SDL_Color &color) {
+                this->vertices.push_back({{static_cast<float>(x_pos), static_cast<float>(y_pos)}, color, {0, 0}});
+            }
+            // \brief Get how many rays are in the fan
+            std::size_t get_ray_count() const {
+                return this->vertices.empty() ? 0 : this->vertices.size() - 1;
+            }
+
+            /** Remove the rays whose ends change the shape of the fan the least, until at most a certain amount are left (the first/last rays and edges between colors are always kept)
+             * \param max_rays The most rays to keep
+             */
+            void decimate(const std::size_t &max_rays) {
+                if (this->get_ray_count() <= std::max<std::size_t>(max_rays, 2)) {
+                    return;
+                }
+                const std::size_t count = this->vertices.size();
+                this->previous.resize(count);
+                this->next.resize(count);
+                this->costs.assign(count, __DBL_MAX__);
+                this->removed.assign(count, false);
+                this->queue = {};
+                for (std::size_t i = 1; i < count; i++) {
+                    this->previous[i] = i - 1;
+                    this->next[i] = i + 1;
+                }
+                for (std::size_t i = 2; i + 1 < count; i++) {
+                    this->costs[i] = this->get_cost(i);
+                    this->queue.emplace(this->costs[i], i);
+                }
+
+                // Costs only go stale when a neighbor is removed, so stale entries are skipped rather than taken out of the queue
+                std::size_t rays = count - 1;
+                while (rays > max_rays && !this->queue.empty()) {
+                    const std::pair<double, std::size_t> top = this->queue.top();
+                    this->queue.pop();
+                    if (this->removed[top.second] || top.first != this->costs[top.second]) {
+                        continue;
+                    }
+                    if (top.first == __DBL_MAX__) {
+                        break;
+                    }
+                    this->removed[top.second] = true;
+                    rays--;
+                    const std::size_t before = this->previous[top.second], after = this->next[top.second];
+                    this->next[before] = after;
+                    this->previous[after] = before;
+                    for (const std::size_t &neighbor : {before, after}) {
+                        if (neighbor > 1 && neighbor + 1 < count) {
+                            this->costs[neighbor] = this->get_cost(neighbor);
+                            this->queue.emplace(this->costs[neighbor], neighbor);
+                        }
+                    }
+                }
+
+                std::size_t kept = 1;
+                for (std::size_t i = 1; i < count; i++) {
+                    if (!this->removed[i]) {
+                        this->vertices[kept++] = this->vertices[i];
+                    }
+                }
+                this->vertices.resize(kept);
+            }
+
+            /** Render the fan as a single mesh
+             * \param window The window to render to
+             * \returns 0 on success or a negative error code on failure
+             */
+            int render(bengine::render_window &window) const {
+                return window.fill_triangle_fan(this->vertices);
+            }
+    };
+}
+
+#endif // BENGINE_RAY_FAN_hpp
@@ -5,6 +5,8 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 #include "bengine_helpers.hpp"
 #include "bengine_texture.hpp"
@@ -91,6 +93,8 @@ namespace bengine {
             double x_stretch_factor;
             // \brief The factor used to stretch a y-input when bengine::render_window::stretch_graphics is true
             double y_stretch_factor;
+            // \brief Whether the current render target is drawn to in its own pixels (see bengine::render_window::target_renderer_at_texture), which skips stretching without changing bengine::render_window::stretch_graphics
+            bool unstretched_target = false;
 
             // \brief The SDL_Texture that is used whenever the window's dummy texture is initialized and drawn to
             SDL_Texture *dummy_texture = NULL;
@@ -99,6 +103,84 @@ namespace bengine {
             // \brief Whether the renderer is targeting the window (false) or the dummy texture
             bool render_target = false;
 
+            // \brief Scratch space for building geometry (kept between calls so that it is only allocated once)
+            std::vector<SDL_Vertex> geometry_vertices;
+            std::vector<int> geometry_indices;
+
+            // \brief Primitives of a single color recorded while batching, along with how they will be drawn
+            struct primitive_batch {
+                SDL_Color color;
+                // \brief Drawn with SDL_RenderDrawPoints
+                std::vector<SDL_Point> points;
+                // \brief Connected lines drawn with SDL_RenderDrawLines (one call per strip), with the index that each strip starts at
+                std::vector<SDL_Point> line_points;
+                std::vector<std::size_t> strip_starts;
+                // \brief Drawn with SDL_RenderDrawRects
+                std::vector<SDL_Rect> outlined_rectangles;
+                // \brief Drawn with SDL_RenderFillRects
+                std::vector<SDL_Rect> filled_rectangles;
+            };
+            // \brief Whether primitives are being recorded (true) or drawn immediately
+            bool batching = false;
+            // \brief The batches in use (the first batch_count of them; the rest are kept so that they are only allocated once)
+            std::vector<bengine::render_window::primitive_batch> batches;
+            std::size_t batch_count = 0;
+            // \brief The index of the batch for every color in use (colors packed as RGBA)
+            std::unordered_map<Uint32, std::size_t> batch_lookup;
+            // \brief The color that was recorded last and its batch, which is usually the one needed next
+            Uint32 last_batch_color = 0;
+            std::size_t last_batch = __SIZE_MAX__;
+
+            // \brief Get the batch for a color, starting a new one if there isn't one yet
+            bengine::render_window::primitive_batch &get_batch(const SDL_Color &color) {
+                const Uint32 packed_color = static_cast<Uint32>(color.r) << 24 | static_cast<Uint32>(color.g) << 16 | static_cast<Uint32>(color.b) << 8 | color.a;
+                if (this->last_batch != __SIZE_MAX__ && packed_color == this->last_batch_color) {
+                    return this->batches[this->last_batch];
+                }
+                this->last_batch_color = packed_color;
+                const std::unordered_map<Uint32, std::size_t>::const_iterator found = this->batch_lookup.find(packed_color);
+                if (found != this->batch_lookup.end()) {
+                    this->last_batch = found->second;
+                    return this->batches[this->last_batch];
+                }
+                if (this->batch_count == this->batches.size()) {
+                    this->batches.emplace_back();
+                }
+                this->last_batch = this->batch_count;
+                this->batch_lookup[packed_color] = this->batch_count;
+                bengine::render_window::primitive_batch &output = this->batches[this->batch_count++];
+                output.color = color;
+                output.points.clear();
+                output.line_points.clear();
+                output.strip_starts.clear();
+                output.outlined_rectangles.clear();
+                output.filled_rectangles.clear();
+                return output;
+            }
+            /** Record a line, joining it onto the end of the last strip of its color when possible
+             *
+             * Lines that start where the strip ends are simply added on; opaque lines that start where the strip's last line started (e.g. rays from a common point) are joined by retracing that last line, which draws the exact same pixels again
+             */
+            void batch_line(const SDL_Point &start, const SDL_Point &end, const SDL_Color &color) {
+                bengine::render_window::primitive_batch &batch = this->get_batch(color);
+                const auto is_point = [](const SDL_Point &lhs, const SDL_Point &rhs) {
+                    return lhs.x == rhs.x && lhs.y == rhs.y;
+                };
+                const std::size_t strip_length = batch.strip_starts.empty() ? 0 : batch.line_points.size() - batch.strip_starts.back();
+                if (strip_length >= 2 && is_point(batch.line_points.back(), start)) {
+                    batch.line_points.push_back(end);
+                    return;
+                }
+                if (strip_length >= 2 && color.a == 255 && is_point(batch.line_points[batch.line_points.size() - 2], start)) {
+                    batch.line_points.push_back(start);
+                    batch.line_points.push_back(end);
+                    return;
+                }
+                batch.strip_starts.push_back(batch.line_points.size());
+                batch.line_points.push_back(start);
+                batch.line_points.push_back(end);
+            }
+
             /** Pretty much does the same thing as SDL_SetRenderDrawColor, but will also print an error if something goes wrong
              * \param color The SDL_Color to change the renderer's color to
              * \returns 0 on success or a negative error code on failure
@@ -130,6 +212,10 @@ namespace bengine {
             int stretch_y(const int &y) const {
                 return y * this->y_stretch_factor;
             }
+            // \brief Whether draws to the current render target get stretched
+            bool should_stretch() const {
+                return this->stretch_graphics && !this->unstretched_target;
+            }
 
         public:
             /** bengine::render_window constructor
@@ -427,9 +513,64 @@ namespace bengine {
             }
             // \brief Present the renderer's buffer to the window to see
             void present_renderer() {
+                if (this->batching) {
+                    this->flush_batches();
+                }
                 SDL_RenderPresent(this->renderer);
             }
 
+            /** Start recording pixels, lines, and rectangles instead of drawing them immediately; they are drawn grouped by color (with as few SDL calls as possible) when flushed
+             *
+             * Grouping by color changes the order that primitives are drawn in, and anything else rendered (textures, text, etc) is drawn immediately, so flush before drawing anything that has to go on top of the recorded primitives
+             */
+            void start_batching() {
+                this->batching = true;
+            }
+            // \brief Flush every recorded primitive and go back to drawing them immediately
+            void halt_batching() {
+                this->flush_batches();
+                this->batching = false;
+            }
+            bool is_batching() const {
+                return this->batching;
+            }
+            /** Draw every recorded primitive (changing the draw color once per color)
+             * \returns 0 on success or a negative error code on failure
+             */
+            int flush_batches() {
+                int output = 0;
+                for (std::size_t i = 0; i < this->batch_count; i++) {
+                    const bengine::render_window::primitive_batch &batch = this->batches[i];
+                    if (this->change_draw_color(batch.color) != 0) {
+                        output = -1;
+                        continue;
+                    }
+                    if (!batch.filled_rectangles.empty() && SDL_RenderFillRects(this->renderer, batch.filled_rectangles.data(), batch.filled_rectangles.size()) != 0) {
+                        output = -1;
+                    }
+                    if (!batch.outlined_rectangles.empty() && SDL_RenderDrawRects(this->renderer, batch.outlined_rectangles.data(), batch.outlined_rectangles.size()) != 0) {
+                        output = -1;
+                    }
+                    for (std::size_t strip = 0; strip < batch.strip_starts.size(); strip++) {
+                        const std::size_t end = strip + 1 < batch.strip_starts.size() ? batch.strip_starts[strip + 1] : batch.line_points.size();
+                        if (SDL_RenderDrawLines(this->renderer, batch.line_points.data() + batch.strip_starts[strip], end - batch.strip_starts[strip]) != 0) {
+                            output = -1;
+                        }
+                    }
+                    if (!batch.points.empty() && SDL_RenderDrawPoints(this->renderer, batch.points.data(), batch.points.size()) != 0) {
+                        output = -1;
+                    }
+                }
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw batched primitives [bengine::render_window::flush_batches]";
+                    this->print_error();
+                }
+                this->batch_count = 0;
+                this->batch_lookup.clear();
+                this->last_batch = __SIZE_MAX__;
+                return output;
+            }
+
             // \brief Syncronize the class's dimensional members with the SDL_Window to clear any potential discrepancies
             void syncronize_dimensions() {
                 int width, height;
@@ -473,15 +614,50 @@ namespace bengine {
                 SDL_WarpMouseInWindow(this->window, x, y);
             }
 
+            /** Only allow rendering within a rectangle (until bengine::render_window::reset_clip_rectangle is called)
+             * \param area The rectangle to render within relative to the window (px for all 4 metrics)
+             */
+            void set_clip_rectangle(const SDL_Rect &area) {
+                const SDL_Rect clip = this->should_stretch() ? SDL_Rect{this->stretch_x(area.x), this->stretch_y(area.y), this->stretch_x(area.x + area.w) - this->stretch_x(area.x), this->stretch_y(area.y + area.h) - this->stretch_y(area.y)} : area;
+                if (SDL_RenderSetClipRect(this->renderer, &clip) != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to set its clip rectangle [bengine::render_window::set_clip_rectangle]";
+                    this->print_error();
+                }
+            }
+            // \brief Allow rendering anywhere again
+            void reset_clip_rectangle() {
+                SDL_RenderSetClipRect(this->renderer, NULL);
+            }
+            /** Overwrite a rectangle with a color, alpha included (unlike bengine::render_window::fill_rectangle, nothing is blended; useful for clearing part of a texture to transparent)
+             * \param area The rectangle to overwrite relative to the window (px for all 4 metrics)
+             * \param color The color to overwrite the rectangle with
+             */
+            void clear_rectangle(const SDL_Rect &area, const SDL_Color &color = {0, 0, 0, 0}) {
+                const SDL_Rect dst = this->should_stretch() ? SDL_Rect{this->stretch_x(area.x), this->stretch_y(area.y), this->stretch_x(area.x + area.w) - this->stretch_x(area.x), this->stretch_y(area.y + area.h) - this->stretch_y(area.y)} : area;
+                SDL_BlendMode blend_mode;
+                SDL_GetRenderDrawBlendMode(this->renderer, &blend_mode);
+                SDL_SetRenderDrawBlendMode(this->renderer, SDL_BLENDMODE_NONE);
+                this->change_draw_color(color);
+                if (SDL_RenderFillRect(this->renderer, &dst) != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to clear a rectangle [bengine::render_window::clear_rectangle]";
+                    this->print_error();
+                }
+                SDL_SetRenderDrawBlendMode(this->renderer, blend_mode);
+            }
+
             /** Draw a singular pixel
              * \param x x-position of the pixel to change relative to the window
              * \param y y-position of the pixel to change relative to the window
              * \param color The color to change the pixel to as an SDL_Color
              */
             void draw_pixel(const int &x, const int &y, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                if (this->batching) {
+                    this->get_batch(color).points.push_back(this->should_stretch() ? SDL_Point{this->stretch_x(x), this->stretch_y(y)} : SDL_Point{x, y});
+                    return;
+                }
                 this->change_draw_color(color);
 
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     if (SDL_RenderDrawPoint(this->renderer, this->stretch_x(x), this->stretch_y(y)) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a pixel [bengine::render_window::draw_pixel]";
                         this->print_error();
@@ -506,16 +682,26 @@ namespace bengine {
                     return;
                 }
 
-                if (this->stretch_graphics) {
-                    if (x1 == x2) {
-                        this->draw_rectangle(this->stretch_x(x1), this->stretch_y(y1), 1, this->stretch_y(y2) - this->stretch_y(y1), color);
+                if (this->should_stretch()) {
+                    // The stretched endpoints are already in the target's pixels, so they go around bengine::render_window::draw_rectangle (which would stretch them again)
+                    if (x1 == x2 || y1 == y2) {
+                        const SDL_Rect dst = x1 == x2 ? SDL_Rect{this->stretch_x(x1), this->stretch_y(y1), 1, this->stretch_y(y2) - this->stretch_y(y1)} : SDL_Rect{this->stretch_x(x1), this->stretch_y(y1), this->stretch_x(x2) - this->stretch_x(x1), 1};
+                        if (this->batching) {
+                            this->get_batch(color).outlined_rectangles.push_back(dst);
+                            return;
+                        }
+                        this->change_draw_color(color);
+                        if (SDL_RenderDrawRect(this->renderer, &dst) != 0) {
+                            std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a line [bengine::render_window::draw_line]";
+                            this->print_error();
+                        }
                         return;
                     }
-                    if (y1 == y2) {
-                        this->draw_rectangle(this->stretch_x(x1), this->stretch_y(y1), this->stretch_x(x2) - this->stretch_x(x1), 1, color);
+
+                    if (this->batching) {
+                        this->batch_line({this->stretch_x(x1), this->stretch_y(y1)}, {this->stretch_x(x2), this->stretch_y(y2)}, color);
                         return;
                     }
-
                     this->change_draw_color(color);
                     if (SDL_RenderDrawLine(this->renderer, this->stretch_x(x1), this->stretch_y(y1), this->stretch_x(x2), this->stretch_y(y2)) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a line [bengine::render_window::draw_line]";
@@ -532,6 +718,10 @@ namespace bengine {
                     return;
                 }
 
+                if (this->batching) {
+                    this->batch_line({x1, y1}, {x2, y2}, color);
+                    return;
+                }
                 this->change_draw_color(color);
                 if (SDL_RenderDrawLine(this->renderer, x1, y1, x2, y2) != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a line [bengine::render_window::draw_line]";
@@ -547,17 +737,21 @@ namespace bengine {
              * \param color The color to draw the rectangle with as an SDL_Color
              */
             void draw_rectangle(const int &x, const int &y, const int &w, const int &h, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                if (this->batching) {
+                    this->get_batch(color).outlined_rectangles.push_back(this->should_stretch() ? SDL_Rect{this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)} : SDL_Rect{x, y, w, h});
+                    return;
+                }
                 this->change_draw_color(color);
                 
-                if (this->stretch_graphics) {
-                    const SDL_Rect dst = {x, y, w, h};
+                if (this->should_stretch()) {
+                    const SDL_Rect dst = {this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)};
                     if (SDL_RenderDrawRect(this->renderer, &dst) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a rectangle [bengine::render_window::draw_rectangle]";
                         this->print_error();
                     }
                     return;
                 }
-                const SDL_Rect dst = {this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)};
+                const SDL_Rect dst = {x, y, w, h};
                 if (SDL_RenderDrawRect(this->renderer, &dst) != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a rectangle [bengine::render_window::draw_rectangle]";
                     this->print_error();
@@ -573,8 +767,6 @@ namespace bengine {
              * \param color The color to draw the rectangle with as an SDL_Color
              */
             void draw_thick_rectangle(const int &x, const int &y, const int &w, const int &h, const int &thickness, const bengine::render_window::thickness_mode &mode = bengine::render_window::thickness_mode::INNER, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                this->change_draw_color(color);
-
                 SDL_Rect rect[4];
                 switch (mode) {
                     default:
@@ -598,7 +790,7 @@ namespace bengine {
                         break;
                 }
 
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     for (unsigned char i = 0; i < 4; i++) {
                         rect[i].x = this->stretch_x(rect[i].x);
                         rect[i].y = this->stretch_y(rect[i].y);
@@ -607,6 +799,12 @@ namespace bengine {
                     }
                 }
 
+                if (this->batching) {
+                    std::vector<SDL_Rect> &filled_rectangles = this->get_batch(color).filled_rectangles;
+                    filled_rectangles.insert(filled_rectangles.end(), rect, rect + 4);
+                    return;
+                }
+                this->change_draw_color(color);
                 if (SDL_RenderFillRect(this->renderer, &rect[0]) != 0 || SDL_RenderFillRect(this->renderer, &rect[1]) != 0 || SDL_RenderFillRect(this->renderer, &rect[2]) != 0 || SDL_RenderFillRect(this->renderer, &rect[3]) != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a thick rectangle [bengine::render_window::draw_thick_rectangle]";
                     this->print_error();
@@ -620,17 +818,21 @@ namespace bengine {
              * \param color The color to fill the rectangle with as an SDL_Color
              */
             void fill_rectangle(const int &x, const int &y, const int &w, const int &h, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                if (this->batching) {
+                    this->get_batch(color).filled_rectangles.push_back(this->should_stretch() ? SDL_Rect{this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)} : SDL_Rect{x, y, w, h});
+                    return;
+                }
                 this->change_draw_color(color);
 
-                if (this->stretch_graphics) {
-                    const SDL_Rect dst = {x, y, w, h};
+                if (this->should_stretch()) {
+                    const SDL_Rect dst = {this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)};
                     if (SDL_RenderFillRect(this->renderer, &dst) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to fill a rectangle [bengine::render_window::fill_rectangle]";
                         this->print_error();
                     }
                     return;
                 }
-                const SDL_Rect dst = {this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)};
+                const SDL_Rect dst = {x, y, w, h};
                 if (SDL_RenderFillRect(this->renderer, &dst) != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to fill a rectangle [bengine::render_window::fill_rectangle]";
                     this->print_error();
@@ -700,6 +902,47 @@ namespace bengine {
                 }
             }
 
+            /** Render triangles in a single draw call
+             * \param texture The texture to map onto the triangles (NULL to only use vertex colors)
+             * \param vertices The corners of the triangles, relative to the window (px for positions, 0-1 for texture coordinates)
+             * \param indices Which vertices make up each triangle (3 per triangle)
+             * \returns 0 on success or a negative error code on failure
+             */
+            int render_geometry(SDL_Texture *texture, const std::vector<SDL_Vertex> &vertices, const std::vector<int> &indices) {
+                if (vertices.empty() || indices.empty()) {
+                    return 0;
+                }
+                const SDL_Vertex *output_vertices = vertices.data();
+                if (this->should_stretch()) {
+                    this->geometry_vertices.assign(vertices.begin(), vertices.end());
+                    for (SDL_Vertex &vertex : this->geometry_vertices) {
+                        vertex.position.x *= this->x_stretch_factor;
+                        vertex.position.y *= this->y_stretch_factor;
+                    }
+                    output_vertices = this->geometry_vertices.data();
+                }
+                const int output = SDL_RenderGeometry(this->renderer, texture, output_vertices, vertices.size(), indices.data(), indices.size());
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render geometry [bengine::render_window::render_geometry]";
+                    this->print_error();
+                }
+                return output;
+            }
+            /** Fill a triangle fan in a single draw call (colors are blended across each triangle)
+             * \param vertices The center of the fan followed by the points around its edge in order, relative to the window (px for positions)
+             * \returns 0 on success or a negative error code on failure
+             */
+            int fill_triangle_fan(const std::vector<SDL_Vertex> &vertices) {
+                if (vertices.size() < 3) {
+                    return 0;
+                }
+                this->geometry_indices.clear();
+                for (std::size_t i = 1; i + 1 < vertices.size(); i++) {
+                    this->geometry_indices.insert(this->geometry_indices.end(), {0, static_cast<int>(i), static_cast<int>(i + 1)});
+                }
+                return this->render_geometry(NULL, vertices, this->geometry_indices);
+            }
+
             /** Load an SDL_Texture using the window's renderer
              * \param filepath The path to the file to load in as an SDL_Texture
              * \returns An SDL_Texture of the image file located at filepath
@@ -763,6 +1006,7 @@ namespace bengine {
                     this->print_error();
                 } else {
                     this->render_target = true;
+                    this->unstretched_target = false;
                 }
                 return output;
             }
@@ -776,6 +1020,22 @@ namespace bengine {
                     this->print_error();
                 } else {
                     this->render_target = false;
+                    this->unstretched_target = false;
+                }
+                return output;
+            }
+            /** Target the renderer at a texture other than the dummy texture (it has to have been created with SDL_TEXTUREACCESS_TARGET, like the ones made by bengine::render_window::duplicate_dummy)
+             * \param texture The texture to render onto
+             * \param stretch Whether draws to the texture get stretched like draws to the window (false for textures that are drawn to in their own pixels, e.g. ones at a resolution other than the window's)
+             * \returns 0 on success or a negative error code on failure
+             */
+            int target_renderer_at_texture(SDL_Texture *texture, const bool &stretch = true) {
+                const int output = SDL_SetRenderTarget(this->renderer, texture);
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to switch the rendering target to a texture [bengine::render_window::target_renderer_at_texture]";
+                    this->print_error();
+                } else {
+                    this->unstretched_target = !stretch;
                 }
                 return output;
             }
@@ -806,13 +1066,57 @@ namespace bengine {
                 return output;
             }
 
+            /** Create a texture that can be rendered onto (with bengine::render_window::target_renderer_at_texture) and blended over whatever is below it
+             * \param width The width of the texture (px)
+             * \param height The height of the texture (px)
+             * \returns The texture, or NULL on failure
+             */
+            SDL_Texture* create_target_texture(const int &width, const int &height) {
+                SDL_Texture *output = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+                if (output == NULL) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to create target texture [bengine::render_window::create_target_texture]";
+                    this->print_error();
+                    return output;
+                }
+                SDL_SetTextureBlendMode(output, SDL_BLENDMODE_BLEND);
+                return output;
+            }
+            /** Create a texture whose pixels can be overwritten directly with bengine::render_window::update_texture (much cheaper than rendering onto it for small changes)
+             * \param width The width of the texture (px)
+             * \param height The height of the texture (px)
+             * \returns The texture (pixels are in SDL_PIXELFORMAT_ARGB8888), or NULL on failure
+             */
+            SDL_Texture* create_streaming_texture(const int &width, const int &height) {
+                SDL_Texture *output = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+                if (output == NULL) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to create streaming texture [bengine::render_window::create_streaming_texture]";
+                    this->print_error();
+                }
+                return output;
+            }
+            /** Overwrite part of a texture made by bengine::render_window::create_streaming_texture
+             * \param texture The texture to write to
+             * \param area The portion of the texture to write to (px for all 4 metrics)
+             * \param pixels The top-left pixel to copy from (SDL_PIXELFORMAT_ARGB8888)
+             * \param pitch The amount of bytes from the start of one row of pixels to the next
+             * \returns 0 on success or a negative error code on failure
+             */
+            int update_texture(SDL_Texture *texture, const SDL_Rect &area, const void *pixels, const int &pitch) {
+                const int output = SDL_UpdateTexture(texture, &area, pixels, pitch);
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to update texture [bengine::render_window::update_texture]";
+                    this->print_error();
+                }
+                return output;
+            }
+
             /** Render an SDL_Texture
              * \param texture The SDL_Texture to render
              * \param src The portion of the SDL_Texture to copy and render (px for all 4 metrics)
              * \param dst The portion of the window/dummy texture to copy to (px for all 4 metrics) (will stretch the texture to fill the given rectangle)
              */
             void render_SDLTexture(SDL_Texture *texture, const SDL_Rect &src, const SDL_Rect &dst) {
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopy(this->renderer, texture, &src, &destination) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render SDL_Texture [bengine::render_window::render_SDLTexture]";
@@ -834,7 +1138,7 @@ namespace bengine {
              * \param flip How to flip the rectangle (SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL can be OR'd together)
              */
             void render_SDLTexture(SDL_Texture *texture, const SDL_Rect &src, const SDL_Rect &dst, const double &angle, const SDL_Point &center, const SDL_RendererFlip &flip) {
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopyEx(this->renderer, texture, &src, &destination, -angle, &center, flip) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render SDL_Texture [bengine::render_window::render_SDLTexture]";
@@ -854,7 +1158,7 @@ namespace bengine {
              */
             void render_basic_texture(const bengine::basic_texture &texture, const SDL_Rect &dst) {
                 const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopy(this->renderer, texture.get_texture(), &frame, &destination) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::basic_texture [bengine::render_window::render_basic_texture]";
@@ -876,7 +1180,7 @@ namespace bengine {
              */
             void render_basic_texture(const bengine::basic_texture &texture, const SDL_Rect &dst, const double &angle, const SDL_Point &pivot, const SDL_RendererFlip &flip) {
                 const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &destination, -angle, &pivot, flip) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::basic_texture [bengine::render_window::render_basic_texture]";
@@ -896,7 +1200,7 @@ namespace bengine {
              */
             void render_modded_texture(const bengine::modded_texture &texture, const SDL_Rect &dst) {
                 const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopy(this->renderer, texture.get_texture(), &frame, &destination) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::modded_texture [bengine::render_window::render_modded_texture]";
@@ -918,7 +1222,7 @@ namespace bengine {
              */
             void render_modded_texture(const bengine::modded_texture &texture, const SDL_Rect &dst, const double &angle, const SDL_Point &pivot, const SDL_RendererFlip &flip) {
                 const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &destination, -angle, &pivot, flip) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::modded_texture [bengine::render_window::render_modded_texture]";
@@ -939,7 +1243,7 @@ namespace bengine {
             void render_shifting_texture(const bengine::shifting_texture &texture, const SDL_Rect &dst) {
                 const SDL_Rect frame = texture.get_frame();
                 const SDL_Point pivot = texture.get_pivot();
-                if (this->stretch_graphics) {
+                if (this->should_stretch()) {
                     const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
                     if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &destination, -texture.get_angle(), &pivot, texture.get_flip()) != 0) {
                         std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::shifting_texture [bengine::render_window::render_shifting_texture]";
@@ -964,12 +1268,21 @@ namespace bengine {
             void render_text(TTF_Font *font, const char16_t *text, const int &x, const int &y, const Uint32 &wrapWidth = 0, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
                 SDL_Surface *surface = TTF_RenderUNICODE_Blended_Wrapped(font, (Uint16*)text, color, wrapWidth);
 
+                if (surface == NULL) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render text [bengine::render_window::render_text]";
+                    this->print_error();
+                    return;
+                }
+                SDL_Texture *texture = SDL_CreateTextureFromSurface(this->renderer, surface);
+
                 const SDL_Rect src = {0, 0, surface->w, surface->h};
                 const SDL_Rect dst = {x, y, surface->w, surface->h};
-                this->render_SDLTexture(SDL_CreateTextureFromSurface(this->renderer, surface), src, dst);
+                this->render_SDLTexture(texture, src, dst);
                 
                 SDL_FreeSurface(surface);
+                SDL_DestroyTexture(texture);
                 surface = nullptr;
+                texture = nullptr;
             }
             /** Render text using a TTF_Font based off of a point (supports most unicode characters)
              * \param font The TTF_Font to use (represents both the font and size of the font)
@@ -979,6 +1292,11 @@ namespace bengine {
              */
             void render_text(TTF_Font *font, const char16_t *text, const SDL_Rect &dst, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
                 SDL_Surface *surface = TTF_RenderUNICODE_Blended_Wrapped(font, (Uint16*)text, color, dst.w);
+                if (surface == NULL) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render text [bengine::render_window::render_text]";
+                    this->print_error();
+                    return;
+                }
                 SDL_Texture *texture = SDL_CreateTextureFromSurface(this->renderer, surface);
                 
                 const SDL_Rect src = {0, 0, surface->w, surface->h};
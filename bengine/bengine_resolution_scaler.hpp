@@ -0,0 +1,91 @@
+#ifndef BENGINE_RESOLUTION_SCALER_hpp
+#define BENGINE_RESOLUTION_SCALER_hpp
+
+#include <algorithm>
+#include <cmath>
+
+namespace bengine {
+    /** A controller for dynamic resolution: given how long each frame took, it picks the fraction of the window's resolution to render at so that frames stay within a time budget
+     *
+     * Frame times are smoothed, and the scale only moves in fixed steps once the smoothed time leaves the budget (or drops far enough under it), so the resolution doesn't flicker between sizes every frame
+     */
+    class resolution_scaler {
+        private:
+            // \brief How long a frame should take (ms)
+            double target_time;
+            double min_scale;
+            double max_scale;
+            // \brief The size of each change to the scale (the scale is always a multiple of this)
+            double step;
+            double scale;
+            // \brief The smoothed frame time (ms), or a negative number before the first frame
+            double average_time = -1;
+            // \brief How much weight each new frame time has in the smoothed frame time
+            double smoothing = 0.1;
+            // \brief How far under the budget (as a fraction of it) the smoothed frame time has to be before the scale goes up
+            double headroom = 0.8;
+
+        public:
+            /** Create a resolution scaler (starting at the max scale)
+             * \param target_time How long a frame should take (ms)
+             * \param min_scale The lowest fraction of the window's resolution to render at
+             * \param max_scale The highest fraction of the window's resolution to render at
+             * \param step The size of each change to the scale
+             */
+            resolution_scaler(const double &target_time = 1000.0 / 60, const double &min_scale = 0.25, const double &max_scale = 1, const double &step = 0.125) {
+                this->target_time = target_time;
+                this->step = step;
+                this->min_scale = std::ceil(min_scale / step) * step;
+                this->max_scale = std::max(this->min_scale, std::floor(max_scale / step) * step);
+                this->scale = this->max_scale;
+            }
+
+            double get_target_time() const {
+                return this->target_time;
+            }
+            void set_target_time(const double &target_time) {
+                this->target_time = target_time;
+            }
+            // \brief Get the fraction of the window's resolution to render at
+            double get_scale() const {
+                return this->scale;
+            }
+            // \brief Get the smoothed frame time (ms)
+            double get_average_time() const {
+                return std::max(this->average_time, 0.0);
+            }
+            /** Scale a length (e.g. the width of the window) by the current scale
+             * \returns The scaled length (at least 1)
+             */
+            int apply(const int &length) const {
+                return std::max(1, static_cast<int>(length * this->scale));
+            }
+
+            /** Feed the scaler how long the last frame took, adjusting the scale if the frame time has left the budget
+             * \param frame_time How long the last frame took (ms)
+             * \returns Whether the scale changed
+             */
+            bool update(const double &frame_time) {
+                this->average_time = this->average_time < 0 ? frame_time : this->average_time + (frame_time - this->average_time) * this->smoothing;
+                // Most of the work (casting/filling columns) grows with the area rendered, so the scale needed to hit the budget goes with the square root of the time ratio
+                double wanted = this->scale;
+                if (this->average_time > this->target_time) {
+                    wanted = std::min(this->scale - this->step, this->scale * std::sqrt(this->target_time / this->average_time));
+                } else if (this->average_time < this->target_time * this->headroom) {
+                    wanted = this->scale + this->step;
+                } else {
+                    return false;
+                }
+                wanted = std::clamp(std::round(wanted / this->step) * this->step, this->min_scale, this->max_scale);
+                if (wanted == this->scale) {
+                    return false;
+                }
+                // The old frame times were measured at the old scale, so they are scaled along with it
+                this->average_time *= (wanted * wanted) / (this->scale * this->scale);
+                this->scale = wanted;
+                return true;
+            }
+    };
+}
+
+#endif // BENGINE_RESOLUTION_SCALER_hpp
@@ -0,0 +1,306 @@
+#ifndef BENGINE_SPATIAL_HASH_hpp
+#define BENGINE_SPATIAL_HASH_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "bengine_colliders.hpp"
+
+namespace bengine {
+    /** A broadphase that buckets colliders into the cells of a uniform grid (hashed, so the world doesn't need to have fixed bounds)
+     *
+     * Colliders are referred to through the IDs handed out when they are inserted; static colliders are expected to never move while dynamic colliders can be updated every tick
+     */
+    class spatial_hash_2d {
+        public:
+            // \brief The first collider hit by a collider sweeping through the hash
+            struct cast_hit {
+                // \brief The ID of the collider that was hit
+                std::size_t id;
+                bengine::basic_collider_2d::sweep_hit hit;
+            };
+
+        private:
+            struct entry {
+                bengine::basic_collider_2d collider;
+                // \brief The range of cells that the collider currently occupies (inclusive)
+                long int min_cell_x, min_cell_y, max_cell_x, max_cell_y;
+                bool is_static;
+                bool is_active;
+                // \brief The last query that found this entry; prevents colliders spanning several cells from being reported more than once
+                mutable std::size_t query_stamp;
+            };
+
+            // \brief The side length of each cell (world units)
+            double cell_size = 4;
+            std::vector<bengine::spatial_hash_2d::entry> entries;
+            // \brief IDs of removed entries that can be handed out again
+            std::vector<std::size_t> free_ids;
+            std::unordered_map<std::uint64_t, std::vector<std::size_t>> cells;
+            mutable std::size_t query_count = 0;
+
+            static std::uint64_t get_key(const long int &cell_x, const long int &cell_y) {
+                return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell_y)) << 32) | static_cast<std::uint32_t>(cell_x);
+            }
+            long int get_cell_coordinate(const double &position) const {
+                return std::floor(position / this->cell_size);
+            }
+
+            void add_to_cells(const std::size_t &id) {
+                const bengine::spatial_hash_2d::entry &entry = this->entries[id];
+                for (long int cell_y = entry.min_cell_y; cell_y <= entry.max_cell_y; cell_y++) {
+                    for (long int cell_x = entry.min_cell_x; cell_x <= entry.max_cell_x; cell_x++) {
+                        this->cells[bengine::spatial_hash_2d::get_key(cell_x, cell_y)].emplace_back(id);
+                    }
+                }
+            }
+            void remove_from_cells(const std::size_t &id) {
+                const bengine::spatial_hash_2d::entry &entry = this->entries[id];
+                for (long int cell_y = entry.min_cell_y; cell_y <= entry.max_cell_y; cell_y++) {
+                    for (long int cell_x = entry.min_cell_x; cell_x <= entry.max_cell_x; cell_x++) {
+                        const auto cell = this->cells.find(bengine::spatial_hash_2d::get_key(cell_x, cell_y));
+                        if (cell == this->cells.end()) {
+                            continue;
+                        }
+                        std::vector<std::size_t> &ids = cell->second;
+                        for (std::size_t i = 0; i < ids.size(); i++) {
+                            if (ids[i] == id) {
+                                ids[i] = ids.back();
+                                ids.pop_back();
+                                break;
+                            }
+                        }
+                        if (ids.empty()) {
+                            this->cells.erase(cell);
+                        }
+                    }
+                }
+            }
+            void calculate_cell_range(bengine::spatial_hash_2d::entry &entry) const {
+                entry.min_cell_x = this->get_cell_coordinate(entry.collider.get_left_x());
+                entry.max_cell_x = this->get_cell_coordinate(entry.collider.get_right_x());
+                entry.min_cell_y = this->get_cell_coordinate(entry.collider.get_bottom_y());
+                entry.max_cell_y = this->get_cell_coordinate(entry.collider.get_top_y());
+            }
+
+            /** Call a function on every active entry sharing a cell with a range of cells (each entry is visited at most once)
+             * \param min_x The left side of the area being searched
+             * \param min_y The bottom side of the area being searched
+             * \param max_x The right side of the area being searched
+             * \param max_y The top side of the area being searched
+             * \param function The function to call with each entry's ID
+             */
+            template <class function_type> void visit_area(const double &min_x, const double &min_y, const double &max_x, const double &max_y, const function_type &function) const {
+                const std::size_t stamp = ++this->query_count;
+                const long int min_cell_x = this->get_cell_coordinate(min_x), max_cell_x = this->get_cell_coordinate(max_x);
+                const long int min_cell_y = this->get_cell_coordinate(min_y), max_cell_y = this->get_cell_coordinate(max_y);
+                for (long int cell_y = min_cell_y; cell_y <= max_cell_y; cell_y++) {
+                    for (long int cell_x = min_cell_x; cell_x <= max_cell_x; cell_x++) {
+                        const auto cell = this->cells.find(bengine::spatial_hash_2d::get_key(cell_x, cell_y));
+                        if (cell == this->cells.end()) {
+                            continue;
+                        }
+                        for (const std::size_t &id : cell->second) {
+                            if (this->entries[id].query_stamp == stamp) {
+                                continue;
+                            }
+                            this->entries[id].query_stamp = stamp;
+                            function(id);
+                        }
+                    }
+                }
+            }
+
+        public:
+            /** bengine::spatial_hash_2d constructor
+             * \param cell_size The side length of each cell (world units); ideally around the size of the typical dynamic collider
+             */
+            spatial_hash_2d(const double &cell_size = 4) {
+                this->cell_size = cell_size <= 0 ? 1 : cell_size;
+            }
+
+            double get_cell_size() const {
+                return this->cell_size;
+            }
+            // \brief Get the amount of colliders currently stored
+            std::size_t get_size() const {
+                return this->entries.size() - this->free_ids.size();
+            }
+            bool contains(const std::size_t &id) const {
+                return id < this->entries.size() && this->entries[id].is_active;
+            }
+            bool is_static(const std::size_t &id) const {
+                return this->entries.at(id).is_static;
+            }
+            const bengine::basic_collider_2d &get_collider(const std::size_t &id) const {
+                return this->entries.at(id).collider;
+            }
+
+            /** Add a collider to the hash
+             * \param collider The collider to add
+             * \param is_static Whether the collider will stay still (true) or is expected to move (false)
+             * \returns The ID that the collider can be referred to with from now on
+             */
+            std::size_t insert(const bengine::basic_collider_2d &collider, const bool &is_static = false) {
+                std::size_t id;
+                if (this->free_ids.empty()) {
+                    id = this->entries.size();
+                    this->entries.emplace_back();
+                } else {
+                    id = this->free_ids.back();
+                    this->free_ids.pop_back();
+                }
+                bengine::spatial_hash_2d::entry &entry = this->entries[id];
+                entry.collider = collider;
+                entry.is_static = is_static;
+                entry.is_active = true;
+                entry.query_stamp = 0;
+                this->calculate_cell_range(entry);
+                this->add_to_cells(id);
+                return id;
+            }
+            /** Remove a collider from the hash (its ID may be handed out again by a later insertion)
+             * \param id The ID of the collider
+             */
+            void remove(const std::size_t &id) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                this->remove_from_cells(id);
+                this->entries[id].is_active = false;
+                this->free_ids.emplace_back(id);
+            }
+            /** Move/resize a collider that is already in the hash; the collider is only re-bucketed if the cells that it covers change
+             * \param id The ID of the collider
+             * \param collider The new bounds of the collider
+             */
+            void update(const std::size_t &id, const bengine::basic_collider_2d &collider) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                bengine::spatial_hash_2d::entry moved = this->entries[id];
+                moved.collider = collider;
+                this->calculate_cell_range(moved);
+                const bengine::spatial_hash_2d::entry &entry = this->entries[id];
+                if (moved.min_cell_x == entry.min_cell_x && moved.min_cell_y == entry.min_cell_y && moved.max_cell_x == entry.max_cell_x && moved.max_cell_y == entry.max_cell_y) {
+                    this->entries[id].collider = collider;
+                    return;
+                }
+                this->remove_from_cells(id);
+                this->entries[id] = moved;
+                this->add_to_cells(id);
+            }
+            // \brief Remove every collider from the hash
+            void clear() {
+                this->entries.clear();
+                this->free_ids.clear();
+                this->cells.clear();
+            }
+
+            /** Find every collider overlapping an area
+             * \param bounds The area to search
+             * \param output The vector to append the IDs of overlapping colliders to (in ascending order)
+             * \param include_static Whether to report static colliders
+             * \param include_dynamic Whether to report dynamic colliders
+             */
+            void query_aabb(const bengine::basic_collider_2d &bounds, std::vector<std::size_t> &output, const bool &include_static = true, const bool &include_dynamic = true) const {
+                const std::size_t output_start = output.size();
+                this->visit_area(bounds.get_left_x(), bounds.get_bottom_y(), bounds.get_right_x(), bounds.get_top_y(), [&](const std::size_t &id) {
+                    const bengine::spatial_hash_2d::entry &entry = this->entries[id];
+                    if ((entry.is_static ? include_static : include_dynamic) && entry.collider.detect_collision(bounds)) {
+                        output.emplace_back(id);
+                    }
+                });
+                std::sort(output.begin() + output_start, output.end());
+            }
+            /** Find every collider within a certain distance of a point
+             * \param x_pos x-position of the center of the search
+             * \param y_pos y-position of the center of the search
+             * \param radius How far from the center to search
+             * \param output The vector to append the IDs of colliders within the radius to (in ascending order)
+             * \param include_static Whether to report static colliders
+             * \param include_dynamic Whether to report dynamic colliders
+             */
+            void query_radius(const double &x_pos, const double &y_pos, const double &radius, std::vector<std::size_t> &output, const bool &include_static = true, const bool &include_dynamic = true) const {
+                const std::size_t output_start = output.size();
+                const double radius_squared = radius * radius;
+                this->visit_area(x_pos - radius, y_pos - radius, x_pos + radius, y_pos + radius, [&](const std::size_t &id) {
+                    const bengine::spatial_hash_2d::entry &entry = this->entries[id];
+                    if (!(entry.is_static ? include_static : include_dynamic)) {
+                        return;
+                    }
+                    // Distance from the center to the closest point of the collider
+                    const double x_distance = x_pos - bengine::math_helper::clamp_value_to_range<double>(x_pos, entry.collider.get_left_x(), entry.collider.get_right_x());
+                    const double y_distance = y_pos - bengine::math_helper::clamp_value_to_range<double>(y_pos, entry.collider.get_bottom_y(), entry.collider.get_top_y());
+                    if (x_distance * x_distance + y_distance * y_distance <= radius_squared) {
+                        output.emplace_back(id);
+                    }
+                });
+                std::sort(output.begin() + output_start, output.end());
+            }
+
+            /** Find the first collider that a moving collider would hit
+             * \param collider The moving collider (at the start of its movement)
+             * \param x_motion How far the collider moves horizontally
+             * \param y_motion How far the collider moves vertically
+             * \param ignored_id The ID of a collider to skip (like the moving collider's own entry in the hash)
+             * \returns The earliest hit (ties go to the lowest ID), or std::nullopt if the path is clear
+             */
+            std::optional<bengine::spatial_hash_2d::cast_hit> sweep(const bengine::basic_collider_2d &collider, const double &x_motion, const double &y_motion, const std::optional<std::size_t> &ignored_id = std::nullopt) const {
+                std::optional<bengine::spatial_hash_2d::cast_hit> output = std::nullopt;
+                this->visit_area(collider.get_left_x() + std::fmin(x_motion, 0), collider.get_bottom_y() + std::fmin(y_motion, 0), collider.get_right_x() + std::fmax(x_motion, 0), collider.get_top_y() + std::fmax(y_motion, 0), [&](const std::size_t &id) {
+                    if (ignored_id.has_value() && ignored_id.value() == id) {
+                        return;
+                    }
+                    const std::optional<bengine::basic_collider_2d::sweep_hit> hit = collider.sweep(this->entries[id].collider, x_motion, y_motion);
+                    if (hit.has_value() && (!output.has_value() || hit.value().time < output.value().hit.time || (hit.value().time == output.value().hit.time && id < output.value().id))) {
+                        output = bengine::spatial_hash_2d::cast_hit{id, hit.value()};
+                    }
+                });
+                return output;
+            }
+            /** Move a collider through the hash, stopping at the first impact and sliding the rest of the movement along the surface that was hit
+             * \param collider The collider to move (updated in place)
+             * \param x_motion How far the collider tries to move horizontally
+             * \param y_motion How far the collider tries to move vertically
+             * \param ignored_id The ID of a collider to skip (like the moving collider's own entry in the hash)
+             * \param max_sweeps The most sweeps to do (the first one moves, each one after that slides); any movement left over after the last sweep is dropped
+             * \param skin How far to stop short of any surface that gets hit, which keeps the collider from ending up touching (and therefore colliding with) it
+             * \returns Whether anything was hit
+             */
+            bool move_and_slide(bengine::basic_collider_2d &collider, const double &x_motion, const double &y_motion, const std::optional<std::size_t> &ignored_id = std::nullopt, const unsigned char &max_sweeps = 2, const double &skin = 0.001) const {
+                double x_remaining = x_motion;
+                double y_remaining = y_motion;
+                bool hit_anything = false;
+                for (unsigned char sweep = 0; sweep < max_sweeps && (x_remaining != 0 || y_remaining != 0); sweep++) {
+                    const std::optional<bengine::spatial_hash_2d::cast_hit> hit = this->sweep(collider, x_remaining, y_remaining, ignored_id);
+                    if (!hit.has_value()) {
+                        collider.translate_horizontally(x_remaining);
+                        collider.translate_vertically(y_remaining);
+                        return hit_anything;
+                    }
+                    hit_anything = true;
+
+                    const double time = std::fmax(0, hit.value().hit.time - skin / std::sqrt(x_remaining * x_remaining + y_remaining * y_remaining));
+                    collider.translate_horizontally(x_remaining * time);
+                    collider.translate_vertically(y_remaining * time);
+
+                    // Whatever is left of the movement keeps going along the surface, but not into it
+                    x_remaining *= 1 - time;
+                    y_remaining *= 1 - time;
+                    if (hit.value().hit.normal_x != 0) {
+                        x_remaining = 0;
+                    } else {
+                        y_remaining = 0;
+                    }
+                }
+                return hit_anything;
+            }
+    };
+}
+
+#endif // BENGINE_SPATIAL_HASH_hpp
@@ -0,0 +1,175 @@
+#ifndef BENGINE_SWEEP_AND_PRUNE_hpp
+#define BENGINE_SWEEP_AND_PRUNE_hpp
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "bengine_colliders.hpp"
+
+namespace bengine {
+    /** A broadphase that finds every pair of overlapping colliders by sweeping along the x axis
+     *
+     * The endpoints of every collider are kept sorted between calls and re-sorted with an insertion sort, which is close to linear when colliders only move a little each tick
+     * Unlike bengine::spatial_hash_2d, the cost doesn't depend on how evenly colliders are spread out, which suits dense crowds clustered into a small area
+     */
+    class sweep_and_prune_2d {
+        private:
+            struct endpoint {
+                double value;
+                std::size_t id;
+                // \brief Whether this is the left side (true) or the right side (false) of the collider
+                bool is_min;
+            };
+            struct entry {
+                double min_x, max_x, min_y, max_y;
+                bool is_active;
+            };
+            // \brief A collider whose x range contains the current sweep position (its y range is copied to keep the overlap tests cache-friendly)
+            struct active_entry {
+                std::size_t id;
+                double min_y, max_y;
+            };
+
+            std::vector<bengine::sweep_and_prune_2d::entry> entries;
+            // \brief IDs of removed entries that can be handed out again
+            std::vector<std::size_t> free_ids;
+            // \brief IDs removed since the last sweep; their endpoints are still in the list, so they can't be handed out again until the list is cleaned up
+            std::vector<std::size_t> removed_ids;
+            // \brief The endpoints of every collider, sorted by position as of the last sweep
+            std::vector<bengine::sweep_and_prune_2d::endpoint> endpoints;
+            std::vector<bengine::sweep_and_prune_2d::active_entry> active;
+            // \brief Where each collider is in bengine::sweep_and_prune_2d::active (indexed by ID)
+            std::vector<std::size_t> active_positions;
+
+            // \brief Endpoint order; at equal positions left sides come first so that touching colliders are reported (matching bengine::basic_collider_2d::detect_collision)
+            static bool is_before(const bengine::sweep_and_prune_2d::endpoint &endpoint_1, const bengine::sweep_and_prune_2d::endpoint &endpoint_2) {
+                return endpoint_1.value < endpoint_2.value || (endpoint_1.value == endpoint_2.value && endpoint_1.is_min && !endpoint_2.is_min);
+            }
+            static void set_bounds(bengine::sweep_and_prune_2d::entry &entry, const bengine::basic_collider_2d &collider) {
+                entry.min_x = collider.get_left_x();
+                entry.max_x = collider.get_right_x();
+                entry.min_y = collider.get_bottom_y();
+                entry.max_y = collider.get_top_y();
+            }
+
+        public:
+            sweep_and_prune_2d() {}
+
+            // \brief Get the amount of colliders currently stored
+            std::size_t get_size() const {
+                return this->entries.size() - this->free_ids.size() - this->removed_ids.size();
+            }
+            bool contains(const std::size_t &id) const {
+                return id < this->entries.size() && this->entries[id].is_active;
+            }
+
+            /** Add a collider
+             * \param collider The collider to add
+             * \returns The ID that the collider can be referred to with from now on
+             */
+            std::size_t insert(const bengine::basic_collider_2d &collider) {
+                std::size_t id;
+                if (this->free_ids.empty()) {
+                    id = this->entries.size();
+                    this->entries.emplace_back();
+                    this->active_positions.emplace_back(0);
+                } else {
+                    id = this->free_ids.back();
+                    this->free_ids.pop_back();
+                }
+                bengine::sweep_and_prune_2d::set_bounds(this->entries[id], collider);
+                this->entries[id].is_active = true;
+                // New endpoints start at the end of the list and get sorted into place during the next sweep
+                this->endpoints.push_back({this->entries[id].min_x, id, true});
+                this->endpoints.push_back({this->entries[id].max_x, id, false});
+                return id;
+            }
+            /** Remove a collider (its ID may be handed out again after the next call to bengine::sweep_and_prune_2d::find_pairs)
+             * \param id The ID of the collider
+             */
+            void remove(const std::size_t &id) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                this->entries[id].is_active = false;
+                this->removed_ids.emplace_back(id);
+            }
+            /** Move/resize a collider; the endpoint list is only re-sorted during the next sweep
+             * \param id The ID of the collider
+             * \param collider The new bounds of the collider
+             */
+            void update(const std::size_t &id, const bengine::basic_collider_2d &collider) {
+                if (!this->contains(id)) {
+                    return;
+                }
+                bengine::sweep_and_prune_2d::set_bounds(this->entries[id], collider);
+            }
+            // \brief Remove every collider
+            void clear() {
+                this->entries.clear();
+                this->free_ids.clear();
+                this->removed_ids.clear();
+                this->endpoints.clear();
+                this->active.clear();
+                this->active_positions.clear();
+            }
+
+            /** Find every pair of overlapping colliders
+             * \param pairs Where the pairs are written (cleared first); each pair is stored as (smaller ID, larger ID) and the pairs are sorted
+             */
+            void find_pairs(std::vector<std::pair<std::size_t, std::size_t>> &pairs) {
+                pairs.clear();
+
+                // Drop the endpoints of removed colliders and pick up the new positions of the rest
+                std::size_t kept = 0;
+                for (std::size_t i = 0; i < this->endpoints.size(); i++) {
+                    bengine::sweep_and_prune_2d::endpoint endpoint = this->endpoints[i];
+                    const bengine::sweep_and_prune_2d::entry &entry = this->entries[endpoint.id];
+                    if (!entry.is_active) {
+                        continue;
+                    }
+                    endpoint.value = endpoint.is_min ? entry.min_x : entry.max_x;
+                    this->endpoints[kept++] = endpoint;
+                }
+                this->endpoints.resize(kept);
+                this->free_ids.insert(this->free_ids.end(), this->removed_ids.begin(), this->removed_ids.end());
+                this->removed_ids.clear();
+
+                // The list was sorted last time, so only endpoints that passed each other since then need to move
+                for (std::size_t i = 1; i < this->endpoints.size(); i++) {
+                    const bengine::sweep_and_prune_2d::endpoint endpoint = this->endpoints[i];
+                    std::size_t j = i;
+                    while (j > 0 && bengine::sweep_and_prune_2d::is_before(endpoint, this->endpoints[j - 1])) {
+                        this->endpoints[j] = this->endpoints[j - 1];
+                        j--;
+                    }
+                    this->endpoints[j] = endpoint;
+                }
+
+                // Every collider that opens while another is still open overlaps it on the x axis, so only the y ranges need to be tested
+                this->active.clear();
+                for (const bengine::sweep_and_prune_2d::endpoint &endpoint : this->endpoints) {
+                    if (endpoint.is_min) {
+                        const bengine::sweep_and_prune_2d::entry &entry = this->entries[endpoint.id];
+                        for (const bengine::sweep_and_prune_2d::active_entry &other : this->active) {
+                            if (entry.min_y <= other.max_y && entry.max_y >= other.min_y) {
+                                pairs.emplace_back(std::min(endpoint.id, other.id), std::max(endpoint.id, other.id));
+                            }
+                        }
+                        this->active_positions[endpoint.id] = this->active.size();
+                        this->active.push_back({endpoint.id, entry.min_y, entry.max_y});
+                    } else {
+                        const std::size_t position = this->active_positions[endpoint.id];
+                        this->active[position] = this->active.back();
+                        this->active_positions[this->active[position].id] = position;
+                        this->active.pop_back();
+                    }
+                }
+
+                std::sort(pairs.begin(), pairs.end());
+            }
+    };
+}
+
+#endif // BENGINE_SWEEP_AND_PRUNE_hpp
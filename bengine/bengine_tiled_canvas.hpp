@@ -0,0 +1,325 @@
+#ifndef BENGINE_TILED_CANVAS_hpp
+#define BENGINE_TILED_CANVAS_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "bengine_render_window.hpp"
+
+namespace bengine {
+    /** An image of a grid where every cell is a square of a single color (e.g. a minimap), split into fixed-size tiles that are only painted when they are viewed, so it works for maps far too big to fit in a single texture
+     *
+     * Tiles are kept in a fixed amount of streaming textures, and the least recently viewed tile is painted over when a new one is needed; zoomed out views use coarser levels (each one half the resolution of the last), so memory use does not depend on the size of the map or how much of it is in view
+     */
+    class tiled_canvas_2d {
+        private:
+            struct tile {
+                SDL_Texture *texture = nullptr;
+                // \brief The level and position of the tile (see bengine::tiled_canvas_2d::get_key), or __UINT64_MAX__ if the texture is unused
+                std::uint64_t key = __UINT64_MAX__;
+                // \brief The last frame that the tile was viewed in
+                std::uint64_t last_used = 0;
+                // \brief The part of the tile that needs to be repainted (px), if any
+                int dirty_left = 0, dirty_top = 0, dirty_right = 0, dirty_bottom = 0;
+            };
+
+            std::size_t cols = 0;
+            std::size_t rows = 0;
+            // \brief The side length of each cell at the finest level (px)
+            std::size_t cell_size = 1;
+            // \brief The side length of each tile (px)
+            int tile_size;
+            // \brief The most tiles that are kept at once
+            std::size_t capacity;
+            // \brief The amount of levels; the coarsest one fits the whole map in a single tile
+            std::size_t level_count = 1;
+
+            std::vector<bengine::tiled_canvas_2d::tile> tiles;
+            // \brief The index of every tile in use, by key
+            std::unordered_map<std::uint64_t, std::size_t> lookup;
+            // \brief Cells that changed since the last render (only matters for tiles that are already painted; the rest are painted fresh when viewed)
+            std::vector<std::pair<std::size_t, std::size_t>> dirty_cells;
+            std::uint64_t frame = 0;
+
+            // \brief Scratch space for painting (the pixels, and which column/row each pixel shows)
+            std::vector<std::uint32_t> pixels;
+            std::vector<std::size_t> pixel_cols;
+            std::vector<std::size_t> pixel_rows;
+
+            static std::uint64_t get_key(const std::size_t &level, const std::size_t &tile_col, const std::size_t &tile_row) {
+                return static_cast<std::uint64_t>(level) << 56 | static_cast<std::uint64_t>(tile_row) << 28 | tile_col;
+            }
+            static std::uint32_t to_pixel(const SDL_Color &color) {
+                return static_cast<std::uint32_t>(color.a) << 24 | static_cast<std::uint32_t>(color.r) << 16 | static_cast<std::uint32_t>(color.g) << 8 | color.b;
+            }
+            // \brief Get the width of a level (px)
+            std::size_t get_level_width(const std::size_t &level) const {
+                return (this->cols * this->cell_size + (std::size_t(1) << level) - 1) >> level;
+            }
+            // \brief Get the height of a level (px)
+            std::size_t get_level_height(const std::size_t &level) const {
+                return (this->rows * this->cell_size + (std::size_t(1) << level) - 1) >> level;
+            }
+
+            /** Repaint part of a tile and copy it into the tile's texture; each pixel shows the cell under its top-left corner
+             * \param window The window that the texture belongs to
+             * \param texture The texture of the tile
+             * \param key The key of the tile
+             * \param left The left edge of the part to repaint (px from the left of the tile)
+             * \param top The top edge of the part to repaint (px from the top of the tile)
+             * \param right The right edge of the part to repaint (px from the left of the tile, exclusive)
+             * \param bottom The bottom edge of the part to repaint (px from the top of the tile, exclusive)
+             * \param get_color A function giving the color of a cell (given its column and row)
+             */
+            template <class function_type> void paint(bengine::render_window &window, SDL_Texture *texture, const std::uint64_t &key, int left, int top, int right, int bottom, const function_type &get_color) {
+                const std::size_t level = key >> 56;
+                const std::size_t x_offset = (key & 0xFFFFFFF) * this->tile_size, y_offset = (key >> 28 & 0xFFFFFFF) * this->tile_size;
+                right = std::min<long>(right, static_cast<long>(this->get_level_width(level)) - static_cast<long>(x_offset));
+                bottom = std::min<long>(bottom, static_cast<long>(this->get_level_height(level)) - static_cast<long>(y_offset));
+                if (left >= right || top >= bottom) {
+                    return;
+                }
+                const int width = right - left, height = bottom - top;
+                for (int x = 0; x < width; x++) {
+                    this->pixel_cols[x] = ((x_offset + left + x) << level) / this->cell_size;
+                }
+                for (int y = 0; y < height; y++) {
+                    this->pixel_rows[y] = ((y_offset + top + y) << level) / this->cell_size;
+                }
+
+                // Neighboring pixels usually show the same cell, so colors are only looked up when the cell changes, and repeated rows are copied
+                for (int y = 0; y < height; y++) {
+                    std::uint32_t *row_pixels = this->pixels.data() + y * width;
+                    if (y > 0 && this->pixel_rows[y] == this->pixel_rows[y - 1]) {
+                        std::copy_n(row_pixels - width, width, row_pixels);
+                        continue;
+                    }
+                    std::uint32_t pixel = 0;
+                    for (int x = 0; x < width; x++) {
+                        if (x == 0 || this->pixel_cols[x] != this->pixel_cols[x - 1]) {
+                            pixel = bengine::tiled_canvas_2d::to_pixel(get_color(this->pixel_cols[x], this->pixel_rows[y]));
+                        }
+                        row_pixels[x] = pixel;
+                    }
+                }
+                window.update_texture(texture, {left, top, width, height}, this->pixels.data(), width * sizeof(std::uint32_t));
+            }
+
+            /** Get a tile, painting it over the least recently viewed tile if it is not already painted
+             * \returns The index of the tile, or __SIZE_MAX__ if a texture for it could not be created
+             */
+            template <class function_type> std::size_t acquire(bengine::render_window &window, const std::size_t &level, const std::size_t &tile_col, const std::size_t &tile_row, const function_type &get_color) {
+                const std::uint64_t key = bengine::tiled_canvas_2d::get_key(level, tile_col, tile_row);
+                const std::unordered_map<std::uint64_t, std::size_t>::const_iterator found = this->lookup.find(key);
+                if (found != this->lookup.end()) {
+                    this->tiles[found->second].last_used = this->frame;
+                    return found->second;
+                }
+
+                std::size_t index = 0;
+                if (this->tiles.size() < this->capacity) {
+                    SDL_Texture *texture = window.create_streaming_texture(this->tile_size, this->tile_size);
+                    if (texture == NULL) {
+                        return __SIZE_MAX__;
+                    }
+                    index = this->tiles.size();
+                    this->tiles.emplace_back();
+                    this->tiles.back().texture = texture;
+                } else {
+                    for (std::size_t i = 1; i < this->tiles.size(); i++) {
+                        if (this->tiles[i].last_used < this->tiles[index].last_used) {
+                            index = i;
+                        }
+                    }
+                    this->lookup.erase(this->tiles[index].key);
+                }
+                bengine::tiled_canvas_2d::tile &output = this->tiles[index];
+                output.key = key;
+                output.last_used = this->frame;
+                output.dirty_left = output.dirty_right = 0;
+                this->lookup[key] = index;
+                this->paint(window, output.texture, key, 0, 0, this->tile_size, this->tile_size, get_color);
+                return index;
+            }
+
+            // \brief Repaint the parts of painted tiles that show cells that changed
+            template <class function_type> void flush(bengine::render_window &window, const function_type &get_color) {
+                if (this->dirty_cells.empty()) {
+                    return;
+                }
+                for (const std::pair<std::size_t, std::size_t> &cell : this->dirty_cells) {
+                    for (std::size_t level = 0; level < this->level_count; level++) {
+                        // The pixels that the cell covers (inclusive), which may straddle tiles
+                        const std::size_t left = (cell.first * this->cell_size) >> level, right = ((cell.first + 1) * this->cell_size - 1) >> level;
+                        const std::size_t top = (cell.second * this->cell_size) >> level, bottom = ((cell.second + 1) * this->cell_size - 1) >> level;
+                        for (std::size_t tile_row = top / this->tile_size; tile_row <= bottom / this->tile_size; tile_row++) {
+                            for (std::size_t tile_col = left / this->tile_size; tile_col <= right / this->tile_size; tile_col++) {
+                                const std::unordered_map<std::uint64_t, std::size_t>::const_iterator found = this->lookup.find(bengine::tiled_canvas_2d::get_key(level, tile_col, tile_row));
+                                if (found == this->lookup.end()) {
+                                    continue;
+                                }
+                                bengine::tiled_canvas_2d::tile &dirty_tile = this->tiles[found->second];
+                                const int tile_left = std::max<long>(left - tile_col * this->tile_size, 0), tile_right = std::min<long>(right - tile_col * this->tile_size + 1, this->tile_size);
+                                const int tile_top = std::max<long>(top - tile_row * this->tile_size, 0), tile_bottom = std::min<long>(bottom - tile_row * this->tile_size + 1, this->tile_size);
+                                if (dirty_tile.dirty_left >= dirty_tile.dirty_right) {
+                                    dirty_tile.dirty_left = tile_left;
+                                    dirty_tile.dirty_top = tile_top;
+                                    dirty_tile.dirty_right = tile_right;
+                                    dirty_tile.dirty_bottom = tile_bottom;
+                                } else {
+                                    dirty_tile.dirty_left = std::min(dirty_tile.dirty_left, tile_left);
+                                    dirty_tile.dirty_top = std::min(dirty_tile.dirty_top, tile_top);
+                                    dirty_tile.dirty_right = std::max(dirty_tile.dirty_right, tile_right);
+                                    dirty_tile.dirty_bottom = std::max(dirty_tile.dirty_bottom, tile_bottom);
+                                }
+                            }
+                        }
+                    }
+                }
+                this->dirty_cells.clear();
+
+                // Each tile is repainted with a single upload covering everything that changed in it
+                for (bengine::tiled_canvas_2d::tile &dirty_tile : this->tiles) {
+                    if (dirty_tile.dirty_left < dirty_tile.dirty_right) {
+                        this->paint(window, dirty_tile.texture, dirty_tile.key, dirty_tile.dirty_left, dirty_tile.dirty_top, dirty_tile.dirty_right, dirty_tile.dirty_bottom, get_color);
+                        dirty_tile.dirty_left = dirty_tile.dirty_right = 0;
+                    }
+                }
+            }
+
+        public:
+            /** Create a tiled canvas
+             * \param tile_size The side length of each tile (px)
+             * \param capacity The most tiles to keep at once (should be enough to cover the biggest view; each one takes tile_size * tile_size * 4 bytes)
+             */
+            tiled_canvas_2d(const int &tile_size = 256, const std::size_t &capacity = 64) {
+                this->tile_size = std::max(tile_size, 1);
+                this->capacity = std::max<std::size_t>(capacity, 1);
+                this->pixels.resize(this->tile_size * this->tile_size);
+                this->pixel_cols.resize(this->tile_size);
+                this->pixel_rows.resize(this->tile_size);
+            }
+            tiled_canvas_2d(const bengine::tiled_canvas_2d &) = delete;
+            bengine::tiled_canvas_2d& operator=(const bengine::tiled_canvas_2d &) = delete;
+            // \brief bengine::tiled_canvas_2d deconstructor; destroys every tile's texture
+            ~tiled_canvas_2d() {
+                for (bengine::tiled_canvas_2d::tile &cached_tile : this->tiles) {
+                    SDL_DestroyTexture(cached_tile.texture);
+                }
+            }
+
+            /** Resize the canvas (every tile will be repainted)
+             * \param cols The amount of columns
+             * \param rows The amount of rows
+             * \param cell_size The side length of each cell at the finest level (px)
+             */
+            void resize(const std::size_t &cols, const std::size_t &rows, const std::size_t &cell_size) {
+                this->cols = cols;
+                this->rows = rows;
+                this->cell_size = std::max<std::size_t>(cell_size, 1);
+                this->level_count = 1;
+                while (this->get_level_width(this->level_count - 1) > static_cast<std::size_t>(this->tile_size) || this->get_level_height(this->level_count - 1) > static_cast<std::size_t>(this->tile_size)) {
+                    this->level_count++;
+                }
+                this->mark_all_dirty();
+            }
+
+            std::size_t get_cols() const {
+                return this->cols;
+            }
+            std::size_t get_rows() const {
+                return this->rows;
+            }
+            std::size_t get_cell_size() const {
+                return this->cell_size;
+            }
+            // \brief Get the width of the image at the finest level (px)
+            std::size_t get_width() const {
+                return this->cols * this->cell_size;
+            }
+            // \brief Get the height of the image at the finest level (px)
+            std::size_t get_height() const {
+                return this->rows * this->cell_size;
+            }
+            int get_tile_size() const {
+                return this->tile_size;
+            }
+            std::size_t get_capacity() const {
+                return this->capacity;
+            }
+            std::size_t get_level_count() const {
+                return this->level_count;
+            }
+            // \brief Get how many tiles are currently painted
+            std::size_t get_tile_count() const {
+                return this->lookup.size();
+            }
+
+            // \brief Mark a cell as needing to be repainted
+            void mark_dirty(const std::size_t &col, const std::size_t &row) {
+                if (col < this->cols && row < this->rows && !this->lookup.empty()) {
+                    this->dirty_cells.emplace_back(col, row);
+                }
+            }
+            // \brief Forget every painted tile, so that they are all painted fresh when next viewed
+            void mark_all_dirty() {
+                for (bengine::tiled_canvas_2d::tile &cached_tile : this->tiles) {
+                    cached_tile.key = __UINT64_MAX__;
+                    cached_tile.last_used = 0;
+                    cached_tile.dirty_left = cached_tile.dirty_right = 0;
+                }
+                this->lookup.clear();
+                this->dirty_cells.clear();
+            }
+
+            /** Render part of the canvas, painting any tiles that are needed (and repainting cells that changed)
+             * \param window The window to render to
+             * \param view The part of the canvas to render (px at the finest level for all 4 metrics)
+             * \param dst The portion of the window to render to (px for all 4 metrics)
+             * \param get_color A function giving the color of a cell (given its column and row)
+             */
+            template <class function_type> void render(bengine::render_window &window, const SDL_Rect &view, const SDL_Rect &dst, const function_type &get_color) {
+                this->frame++;
+                this->flush(window, get_color);
+                if (view.w <= 0 || view.h <= 0 || dst.w <= 0 || dst.h <= 0) {
+                    return;
+                }
+
+                // Use the coarsest level that still has at least one pixel per pixel on screen
+                const double ratio = std::min(static_cast<double>(view.w) / dst.w, static_cast<double>(view.h) / dst.h);
+                std::size_t level = 0;
+                while (level + 1 < this->level_count && static_cast<double>(std::size_t(1) << (level + 1)) <= ratio) {
+                    level++;
+                }
+
+                const long left = std::max(view.x, 0) >> level, top = std::max(view.y, 0) >> level;
+                const long right = std::min<long>((static_cast<long>(view.x) + view.w + (1l << level) - 1) >> level, this->get_level_width(level));
+                const long bottom = std::min<long>((static_cast<long>(view.y) + view.h + (1l << level) - 1) >> level, this->get_level_height(level));
+                if (left >= right || top >= bottom) {
+                    return;
+                }
+                const double x_scale = static_cast<double>(dst.w) / view.w * (1l << level), y_scale = static_cast<double>(dst.h) / view.h * (1l << level);
+                const double x_origin = dst.x - static_cast<double>(view.x) / (1l << level) * x_scale, y_origin = dst.y - static_cast<double>(view.y) / (1l << level) * y_scale;
+
+                for (long tile_row = top / this->tile_size; tile_row <= (bottom - 1) / this->tile_size; tile_row++) {
+                    for (long tile_col = left / this->tile_size; tile_col <= (right - 1) / this->tile_size; tile_col++) {
+                        const std::size_t index = this->acquire(window, level, tile_col, tile_row, get_color);
+                        if (index == __SIZE_MAX__) {
+                            continue;
+                        }
+                        const long src_left = std::max(left, tile_col * this->tile_size), src_right = std::min(right, (tile_col + 1) * this->tile_size);
+                        const long src_top = std::max(top, tile_row * this->tile_size), src_bottom = std::min(bottom, (tile_row + 1) * this->tile_size);
+                        // Both edges are rounded the same way as the neighboring tiles' edges, so there are no gaps between tiles
+                        const int dst_left = std::lround(x_origin + src_left * x_scale), dst_right = std::lround(x_origin + src_right * x_scale);
+                        const int dst_top = std::lround(y_origin + src_top * y_scale), dst_bottom = std::lround(y_origin + src_bottom * y_scale);
+                        window.render_SDLTexture(this->tiles[index].texture, {static_cast<int>(src_left - tile_col * this->tile_size), static_cast<int>(src_top - tile_row * this->tile_size), static_cast<int>(src_right - src_left), static_cast<int>(src_bottom - src_top)}, {dst_left, dst_top, dst_right - dst_left, dst_bottom - dst_top});
+                    }
+                }
+            }
+    };
+}
+
+#endif // BENGINE_TILED_CANVAS_hpp
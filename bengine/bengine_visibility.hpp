@@ -0,0 +1,435 @@
+#ifndef BENGINE_VISIBILITY_hpp
+#define BENGINE_VISIBILITY_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bengine_grid.hpp"
+
+namespace bengine {
+    /** The exact area visible from a point inside a bengine::grid_2d, found by sweeping around the point over the corners of the wall faces near it
+     *
+     * The wall faces of the grid are extracted once (and refreshed chunk by chunk when cells are edited), merged into the longest straight runs possible, and bucketed into chunks so that only nearby faces are looked at
+     */
+    class visibility_polygon_2d {
+        private:
+            // \brief A wall face (always axis-aligned), along with the direction pointing out of the wall
+            struct segment {
+                double x_1, y_1, x_2, y_2;
+                double normal_x, normal_y;
+            };
+            // \brief An angle that the sweep has to stop at because a face starts or ends there
+            struct sweep_event {
+                double angle;
+                std::size_t segment;
+                bool is_start;
+
+                bool operator<(const bengine::visibility_polygon_2d::sweep_event &rhs) const {
+                    return this->angle < rhs.angle;
+                }
+            };
+
+            // \brief The side length of each chunk that wall faces are bucketed into (cells)
+            static constexpr std::size_t chunk_side_length = 16;
+
+            std::size_t cols = 0;
+            std::size_t rows = 0;
+            std::size_t chunk_cols = 0;
+            std::size_t chunk_rows = 0;
+            // \brief The wall faces of every chunk; a face on the border between two chunks belongs to the chunk to its right/below
+            std::vector<std::vector<bengine::visibility_polygon_2d::segment>> chunks;
+
+            double origin_x = 0;
+            double origin_y = 0;
+            double range = 0;
+            // \brief The corners of the polygon, in order of increasing angle around the origin
+            std::vector<bengine::coordinate_2d<double>> points;
+
+            std::vector<bengine::visibility_polygon_2d::segment> candidates;
+            std::vector<bengine::visibility_polygon_2d::sweep_event> events;
+            // \brief The faces crossing the current angle of the sweep
+            std::vector<std::size_t> open;
+            // \brief Where each face is in bengine::visibility_polygon_2d::open (only valid while the face is open)
+            std::vector<std::size_t> open_positions;
+
+            static bool is_blocking(const bengine::grid_2d &grid, const long int &col, const long int &row) {
+                // Everything outside of the grid counts as a wall so that the polygon is always closed
+                return !grid.is_in_bounds(col, row) || grid.is_solid(col, row);
+            }
+
+            // \brief Re-extract the wall faces belonging to a single chunk
+            void refresh_chunk(const bengine::grid_2d &grid, const std::size_t &chunk_col, const std::size_t &chunk_row) {
+                std::vector<bengine::visibility_polygon_2d::segment> &faces = this->chunks[chunk_row * this->chunk_cols + chunk_col];
+                faces.clear();
+                const long int first_col = chunk_col * bengine::visibility_polygon_2d::chunk_side_length;
+                const long int first_row = chunk_row * bengine::visibility_polygon_2d::chunk_side_length;
+                // The last chunk on each axis also owns the faces along the far edge of the grid
+                const long int last_col = chunk_col + 1 == this->chunk_cols ? this->cols : first_col + bengine::visibility_polygon_2d::chunk_side_length - 1;
+                const long int last_row = chunk_row + 1 == this->chunk_rows ? this->rows : first_row + bengine::visibility_polygon_2d::chunk_side_length - 1;
+                const long int span_cols = std::min<long int>(first_col + bengine::visibility_polygon_2d::chunk_side_length, this->cols);
+                const long int span_rows = std::min<long int>(first_row + bengine::visibility_polygon_2d::chunk_side_length, this->rows);
+
+                // Horizontal faces lie on the line between row y - 1 and row y; neighboring faces pointing the same way are merged into one
+                for (long int y = first_row; y <= last_row; y++) {
+                    int run_normal = 0;
+                    long int run_start = 0;
+                    for (long int col = first_col; col <= span_cols; col++) {
+                        int normal = 0;
+                        if (col < span_cols) {
+                            const bool above = bengine::visibility_polygon_2d::is_blocking(grid, col, y - 1), below = bengine::visibility_polygon_2d::is_blocking(grid, col, y);
+                            normal = above == below ? 0 : (above ? 1 : -1);
+                        }
+                        if (normal != run_normal) {
+                            if (run_normal != 0) {
+                                faces.push_back({static_cast<double>(run_start), static_cast<double>(y), static_cast<double>(col), static_cast<double>(y), 0, static_cast<double>(run_normal)});
+                            }
+                            run_normal = normal;
+                            run_start = col;
+                        }
+                    }
+                }
+                // Vertical faces lie on the line between col x - 1 and col x
+                for (long int x = first_col; x <= last_col; x++) {
+                    int run_normal = 0;
+                    long int run_start = 0;
+                    for (long int row = first_row; row <= span_rows; row++) {
+                        int normal = 0;
+                        if (row < span_rows) {
+                            const bool left = bengine::visibility_polygon_2d::is_blocking(grid, x - 1, row), right = bengine::visibility_polygon_2d::is_blocking(grid, x, row);
+                            normal = left == right ? 0 : (left ? 1 : -1);
+                        }
+                        if (normal != run_normal) {
+                            if (run_normal != 0) {
+                                faces.push_back({static_cast<double>(x), static_cast<double>(run_start), static_cast<double>(x), static_cast<double>(row), static_cast<double>(run_normal), 0});
+                            }
+                            run_normal = normal;
+                            run_start = row;
+                        }
+                    }
+                }
+            }
+
+            // \brief Get how far along the ray at the given angle it hits the line that a face lies on
+            double get_distance_to(const bengine::visibility_polygon_2d::segment &segment, const double &angle) const {
+                const double x_dir = std::cos(angle), y_dir = std::sin(angle);
+                // Faces are axis-aligned, so only one axis needs to be intersected
+                if (segment.normal_y != 0) {
+                    return y_dir == 0 ? __DBL_MAX__ : (segment.y_1 - this->origin_y) / y_dir;
+                }
+                return x_dir == 0 ? __DBL_MAX__ : (segment.x_1 - this->origin_x) / x_dir;
+            }
+            void add_point(const double &angle, const double &distance) {
+                this->points.emplace_back(this->origin_x + std::cos(angle) * distance, this->origin_y + std::sin(angle) * distance);
+            }
+
+        public:
+            visibility_polygon_2d() {}
+
+            /** Extract the wall faces of a grid (needed before computing any polygons, and again if the grid is resized)
+             * \param grid The grid to extract from
+             */
+            void load(const bengine::grid_2d &grid) {
+                this->cols = grid.get_cols();
+                this->rows = grid.get_rows();
+                this->chunk_cols = std::max<std::size_t>(1, (this->cols + bengine::visibility_polygon_2d::chunk_side_length - 1) / bengine::visibility_polygon_2d::chunk_side_length);
+                this->chunk_rows = std::max<std::size_t>(1, (this->rows + bengine::visibility_polygon_2d::chunk_side_length - 1) / bengine::visibility_polygon_2d::chunk_side_length);
+                this->chunks.assign(this->chunk_cols * this->chunk_rows, std::vector<bengine::visibility_polygon_2d::segment>());
+                for (std::size_t chunk_row = 0; chunk_row < this->chunk_rows; chunk_row++) {
+                    for (std::size_t chunk_col = 0; chunk_col < this->chunk_cols; chunk_col++) {
+                        this->refresh_chunk(grid, chunk_col, chunk_row);
+                    }
+                }
+            }
+            /** Re-extract the wall faces around a cell after it has been edited
+             * \param grid The (already edited) grid
+             * \param col The column of the edited cell
+             * \param row The row of the edited cell
+             */
+            void refresh_cell(const bengine::grid_2d &grid, const std::size_t &col, const std::size_t &row) {
+                // The faces on the right/bottom edges of the cell can belong to the next chunk over
+                for (std::size_t chunk_row = row / bengine::visibility_polygon_2d::chunk_side_length; chunk_row <= std::min(this->chunk_rows - 1, (row + 1) / bengine::visibility_polygon_2d::chunk_side_length); chunk_row++) {
+                    for (std::size_t chunk_col = col / bengine::visibility_polygon_2d::chunk_side_length; chunk_col <= std::min(this->chunk_cols - 1, (col + 1) / bengine::visibility_polygon_2d::chunk_side_length); chunk_col++) {
+                        this->refresh_chunk(grid, chunk_col, chunk_row);
+                    }
+                }
+            }
+
+            double get_origin_x() const {
+                return this->origin_x;
+            }
+            double get_origin_y() const {
+                return this->origin_y;
+            }
+            double get_range() const {
+                return this->range;
+            }
+            /** Get the corners of the most recently computed polygon
+             * \returns The corners, in order of increasing angle around the origin; the polygon is the fan of triangles between the origin and each pair of consecutive corners (wrapping around)
+             */
+            const std::vector<bengine::coordinate_2d<double>> &get_points() const {
+                return this->points;
+            }
+
+            /** Compute the area visible from a point
+             * \param x_pos The x-position to look from
+             * \param y_pos The y-position to look from
+             * \param range How far can be seen; the polygon is clipped to the square of this half-width around the point
+             */
+            void compute(const double &x_pos, const double &y_pos, const double &range) {
+                this->origin_x = x_pos;
+                this->origin_y = y_pos;
+                this->range = std::fabs(range);
+                this->points.clear();
+                this->candidates.clear();
+
+                // The range square is always in front of everything else that's out of range, so it closes the polygon
+                const double min_x = x_pos - this->range, min_y = y_pos - this->range, max_x = x_pos + this->range, max_y = y_pos + this->range;
+                this->candidates.push_back({min_x, min_y, max_x, min_y, 0, 1});
+                this->candidates.push_back({min_x, max_y, max_x, max_y, 0, -1});
+                this->candidates.push_back({min_x, min_y, min_x, max_y, 1, 0});
+                this->candidates.push_back({max_x, min_y, max_x, max_y, -1, 0});
+
+                if (!this->chunks.empty()) {
+                    const long int side = bengine::visibility_polygon_2d::chunk_side_length;
+                    const long int first_chunk_col = std::max<long int>(0, std::floor(min_x / side)), last_chunk_col = std::min<long int>(this->chunk_cols - 1, std::floor(max_x / side));
+                    const long int first_chunk_row = std::max<long int>(0, std::floor(min_y / side)), last_chunk_row = std::min<long int>(this->chunk_rows - 1, std::floor(max_y / side));
+                    for (long int chunk_row = first_chunk_row; chunk_row <= last_chunk_row; chunk_row++) {
+                        for (long int chunk_col = first_chunk_col; chunk_col <= last_chunk_col; chunk_col++) {
+                            for (const bengine::visibility_polygon_2d::segment &segment : this->chunks[chunk_row * this->chunk_cols + chunk_col]) {
+                                // Faces pointing away from the origin are always hidden behind the wall they belong to
+                                if ((x_pos - segment.x_1) * segment.normal_x + (y_pos - segment.y_1) * segment.normal_y <= 0) {
+                                    continue;
+                                }
+                                if (std::max(segment.x_1, segment.x_2) < min_x || std::min(segment.x_1, segment.x_2) > max_x || std::max(segment.y_1, segment.y_2) < min_y || std::min(segment.y_1, segment.y_2) > max_y) {
+                                    continue;
+                                }
+                                // Faces are clipped to the range square so that no two faces cross (the sweep relies on that)
+                                this->candidates.push_back({std::clamp(segment.x_1, min_x, max_x), std::clamp(segment.y_1, min_y, max_y), std::clamp(segment.x_2, min_x, max_x), std::clamp(segment.y_2, min_y, max_y), segment.normal_x, segment.normal_y});
+                            }
+                        }
+                    }
+                }
+
+                // Each face covers the range of angles between its endpoints (always less than half a turn, since the origin is in front of it)
+                this->events.clear();
+                this->open.clear();
+                this->open_positions.resize(this->candidates.size());
+                const auto open_segment = [&](const std::size_t &index) {
+                    this->open_positions[index] = this->open.size();
+                    this->open.emplace_back(index);
+                };
+                for (std::size_t i = 0; i < this->candidates.size(); i++) {
+                    const bengine::visibility_polygon_2d::segment &segment = this->candidates[i];
+                    double angle_1 = std::atan2(segment.y_1 - y_pos, segment.x_1 - x_pos), angle_2 = std::atan2(segment.y_2 - y_pos, segment.x_2 - x_pos);
+                    double span = angle_2 - angle_1;
+                    if (span > C_PI) {
+                        span -= C_2PI;
+                    } else if (span <= -C_PI) {
+                        span += C_2PI;
+                    }
+                    if (span < 0) {
+                        std::swap(angle_1, angle_2);
+                        span = -span;
+                    }
+                    if (span < 1e-12) {
+                        continue;
+                    }
+                    if (angle_1 >= C_PI) {
+                        angle_1 -= C_2PI;
+                    }
+                    double end_angle = angle_1 + span;
+                    // Faces crossing the starting angle of the sweep are open from the very beginning
+                    if (end_angle >= C_PI) {
+                        end_angle -= C_2PI;
+                        open_segment(i);
+                    }
+                    this->events.push_back({angle_1, i, true});
+                    this->events.push_back({end_angle, i, false});
+                }
+                std::sort(this->events.begin(), this->events.end());
+
+                // Between two consecutive event angles the set of open faces doesn't change, so the closest one in the middle of the gap is the closest one across all of it
+                double previous_angle = -C_PI;
+                std::size_t previous_segment = __SIZE_MAX__;
+                std::size_t event = 0;
+                while (true) {
+                    const double angle = event < this->events.size() ? this->events[event].angle : C_PI;
+                    if (angle > previous_angle && !this->open.empty()) {
+                        const double middle = (previous_angle + angle) / 2;
+                        std::size_t closest = this->open[0];
+                        double closest_distance = this->get_distance_to(this->candidates[closest], middle);
+                        for (std::size_t i = 1; i < this->open.size(); i++) {
+                            const double distance = this->get_distance_to(this->candidates[this->open[i]], middle);
+                            if (distance < closest_distance) {
+                                closest_distance = distance;
+                                closest = this->open[i];
+                            }
+                        }
+                        // Consecutive gaps on the same face form one straight edge, so only its far end needs to move
+                        if (closest == previous_segment) {
+                            this->points.pop_back();
+                        } else {
+                            this->add_point(previous_angle, this->get_distance_to(this->candidates[closest], previous_angle));
+                        }
+                        this->add_point(angle, this->get_distance_to(this->candidates[closest], angle));
+                        previous_segment = closest;
+                        previous_angle = angle;
+                    }
+                    if (event == this->events.size()) {
+                        break;
+                    }
+                    for (; event < this->events.size() && this->events[event].angle == angle; event++) {
+                        const std::size_t index = this->events[event].segment;
+                        if (this->events[event].is_start) {
+                            open_segment(index);
+                        } else {
+                            const std::size_t position = this->open_positions[index];
+                            this->open[position] = this->open.back();
+                            this->open_positions[this->open[position]] = position;
+                            this->open.pop_back();
+                        }
+                    }
+                }
+            }
+    };
+
+    /** A bitmap of which cells have been seen at some point, filled in from bengine::visibility_polygon_2d
+     *
+     * Each row keeps a "next unexplored cell" link per cell (with path compression), so revealing a span of a row only touches the cells in it that weren't explored yet
+     */
+    class fog_of_war_2d {
+        private:
+            std::size_t cols = 0;
+            std::size_t rows = 0;
+            std::vector<std::uint8_t> explored;
+            // \brief For each row (cols + 1 entries), a link towards the next unexplored cell at or after each column (the extra entry marks the end of the row)
+            std::vector<std::size_t> next_unexplored;
+            // \brief Cells (row * cols + col) revealed by the most recent call to bengine::fog_of_war_2d::reveal
+            std::vector<std::size_t> revealed;
+            std::size_t explored_count = 0;
+
+            std::size_t find_unexplored(const std::size_t &row, std::size_t col) {
+                std::size_t *links = this->next_unexplored.data() + row * (this->cols + 1);
+                while (links[col] != col) {
+                    // Path halving: every visited link skips over the one after it
+                    links[col] = links[links[col]];
+                    col = links[col];
+                }
+                return col;
+            }
+            void reveal_span(const std::size_t &row, const std::size_t &first_col, const std::size_t &last_col) {
+                std::size_t *links = this->next_unexplored.data() + row * (this->cols + 1);
+                for (std::size_t col = this->find_unexplored(row, first_col); col <= last_col; col = this->find_unexplored(row, col + 1)) {
+                    this->explored[row * this->cols + col] = 1;
+                    links[col] = col + 1;
+                    this->revealed.emplace_back(row * this->cols + col);
+                    this->explored_count++;
+                }
+            }
+            // \brief Reveal every cell touching a triangle
+            void reveal_triangle(const bengine::coordinate_2d<double> &point_1, const bengine::coordinate_2d<double> &point_2, const bengine::coordinate_2d<double> &point_3) {
+                const double epsilon = 1e-9;
+                const double xs[3] = {point_1.get_x_pos(), point_2.get_x_pos(), point_3.get_x_pos()};
+                const double ys[3] = {point_1.get_y_pos(), point_2.get_y_pos(), point_3.get_y_pos()};
+                const double min_y = std::min({ys[0], ys[1], ys[2]}), max_y = std::max({ys[0], ys[1], ys[2]});
+                // Cells that only touch the triangle along an edge are included, which is what reveals the walls that the polygon stops at
+                const long int first_row = std::max<long int>(0, static_cast<long int>(std::ceil(min_y - epsilon)) - 1);
+                const long int last_row = std::min<long int>(this->rows - 1, std::floor(max_y + epsilon));
+
+                for (long int row = first_row; row <= last_row; row++) {
+                    const double band_top = std::max<double>(row, min_y), band_bottom = std::min<double>(row + 1, max_y);
+                    double min_x = __DBL_MAX__, max_x = -__DBL_MAX__;
+                    // The triangle's horizontal extent within the row is found by clipping each of its edges to the row
+                    for (unsigned char i = 0; i < 3; i++) {
+                        const double x_1 = xs[i], y_1 = ys[i], x_2 = xs[(i + 1) % 3], y_2 = ys[(i + 1) % 3];
+                        const double edge_top = std::max(std::min(y_1, y_2), band_top - epsilon), edge_bottom = std::min(std::max(y_1, y_2), band_bottom + epsilon);
+                        if (edge_top > edge_bottom) {
+                            continue;
+                        }
+                        if (y_1 == y_2) {
+                            min_x = std::min({min_x, x_1, x_2});
+                            max_x = std::max({max_x, x_1, x_2});
+                            continue;
+                        }
+                        const double x_top = x_1 + (x_2 - x_1) * (edge_top - y_1) / (y_2 - y_1), x_bottom = x_1 + (x_2 - x_1) * (edge_bottom - y_1) / (y_2 - y_1);
+                        min_x = std::min({min_x, x_top, x_bottom});
+                        max_x = std::max({max_x, x_top, x_bottom});
+                    }
+                    if (min_x > max_x) {
+                        continue;
+                    }
+                    const long int first_col = std::max<long int>(0, static_cast<long int>(std::ceil(min_x - epsilon)) - 1);
+                    const long int last_col = std::min<long int>(this->cols - 1, std::floor(max_x + epsilon));
+                    if (first_col <= last_col) {
+                        this->reveal_span(row, first_col, last_col);
+                    }
+                }
+            }
+
+        public:
+            fog_of_war_2d() {}
+            fog_of_war_2d(const std::size_t &cols, const std::size_t &rows) {
+                this->resize(cols, rows);
+            }
+
+            std::size_t get_cols() const {
+                return this->cols;
+            }
+            std::size_t get_rows() const {
+                return this->rows;
+            }
+            // \brief Get how many cells have been explored in total
+            std::size_t get_explored_count() const {
+                return this->explored_count;
+            }
+            bool is_explored(const std::size_t &col, const std::size_t &row) const {
+                return col < this->cols && row < this->rows && this->explored[row * this->cols + col] != 0;
+            }
+            // \brief Get the cells (stored as row * cols + col) that were revealed by the most recent call to bengine::fog_of_war_2d::reveal
+            const std::vector<std::size_t> &get_revealed_cells() const {
+                return this->revealed;
+            }
+
+            /** Resize the bitmap, hiding every cell in the process
+             * \param cols The new amount of columns
+             * \param rows The new amount of rows
+             */
+            void resize(const std::size_t &cols, const std::size_t &rows) {
+                this->cols = cols;
+                this->rows = rows;
+                this->explored.assign(cols * rows, 0);
+                this->next_unexplored.resize((cols + 1) * rows);
+                for (std::size_t row = 0; row < rows; row++) {
+                    for (std::size_t col = 0; col <= cols; col++) {
+                        this->next_unexplored[row * (cols + 1) + col] = col;
+                    }
+                }
+                this->revealed.clear();
+                this->explored_count = 0;
+            }
+            /** Mark everything inside of a visibility polygon as explored
+             * \param polygon The polygon to reveal
+             * \returns How many cells weren't explored before (see bengine::fog_of_war_2d::get_revealed_cells)
+             */
+            std::size_t reveal(const bengine::visibility_polygon_2d &polygon) {
+                this->revealed.clear();
+                const std::vector<bengine::coordinate_2d<double>> &points = polygon.get_points();
+                const bengine::coordinate_2d<double> origin(polygon.get_origin_x(), polygon.get_origin_y());
+                for (std::size_t i = 0; i < points.size(); i++) {
+                    const bengine::coordinate_2d<double> &point_1 = points[i];
+                    const bengine::coordinate_2d<double> &point_2 = points[(i + 1) % points.size()];
+                    // Corners where the sweep jumps from one face to another lie on the same ray, so they form no area
+                    const double area = (point_1.get_x_pos() - origin.get_x_pos()) * (point_2.get_y_pos() - origin.get_y_pos()) - (point_1.get_y_pos() - origin.get_y_pos()) * (point_2.get_x_pos() - origin.get_x_pos());
+                    if (std::fabs(area) < 1e-12) {
+                        continue;
+                    }
+                    this->reveal_triangle(origin, point_1, point_2);
+                }
+                return this->revealed.size();
+            }
+    };
+}
+
+#endif // BENGINE_VISIBILITY_hpp
@@ -0,0 +1,138 @@
+#ifndef BENGINE_WORKER_POOL_hpp
+#define BENGINE_WORKER_POOL_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bengine {
+    /** A set of persistent worker threads that split up batches of independent tasks
+     *
+     * The thread calling bengine::worker_pool::run works on the batch too and only returns once every task is done; which thread runs which task is not fixed, so tasks should only write to data that no other task in the batch touches
+     */
+    class worker_pool {
+        private:
+            std::vector<std::thread> workers;
+            std::mutex mutex;
+            std::condition_variable start_condition;
+            std::condition_variable done_condition;
+
+            // \brief The batch currently being worked on (only valid while bengine::worker_pool::run is active)
+            const std::function<void(const std::size_t &)> *task = nullptr;
+            std::size_t task_count = 0;
+            std::atomic<std::size_t> next_task = 0;
+            // \brief Incremented every batch so that sleeping workers can tell a new batch apart from a spurious wakeup
+            std::size_t generation = 0;
+            // \brief How many workers are still working on the current batch
+            std::size_t active_workers = 0;
+            bool stopping = false;
+
+            // \brief Keep taking tasks from the current batch until there are none left
+            void work() {
+                std::size_t index;
+                while ((index = this->next_task.fetch_add(1)) < this->task_count) {
+                    (*this->task)(index);
+                }
+            }
+            void worker_loop() {
+                std::size_t seen_generation = 0;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+                        this->start_condition.wait(lock, [&]() {
+                            return this->stopping || this->generation != seen_generation;
+                        });
+                        if (this->stopping) {
+                            return;
+                        }
+                        seen_generation = this->generation;
+                    }
+                    this->work();
+                    {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+                        if (--this->active_workers == 0) {
+                            this->done_condition.notify_all();
+                        }
+                    }
+                }
+            }
+
+        public:
+            /** bengine::worker_pool constructor
+             * \param thread_count The total amount of threads working on each batch, including the one calling bengine::worker_pool::run (0 uses one per hardware thread; 1 runs everything on the calling thread)
+             */
+            worker_pool(const std::size_t &thread_count = 0) {
+                const std::size_t total_threads = thread_count == 0 ? std::max<std::size_t>(1, std::thread::hardware_concurrency()) : thread_count;
+                for (std::size_t i = 1; i < total_threads; i++) {
+                    this->workers.emplace_back(&bengine::worker_pool::worker_loop, this);
+                }
+            }
+            ~worker_pool() {
+                {
+                    std::unique_lock<std::mutex> lock(this->mutex);
+                    this->stopping = true;
+                }
+                this->start_condition.notify_all();
+                for (std::size_t i = 0; i < this->workers.size(); i++) {
+                    this->workers[i].join();
+                }
+            }
+            worker_pool(const bengine::worker_pool &) = delete;
+            bengine::worker_pool& operator=(const bengine::worker_pool &) = delete;
+
+            // \brief Get the total amount of threads working on each batch (including the calling thread)
+            std::size_t get_thread_count() const {
+                return this->workers.size() + 1;
+            }
+
+            /** Run a batch of tasks, returning once all of them are finished
+             * \param task_count The amount of tasks in the batch
+             * \param task The function to run for each task (given the task's index)
+             */
+            void run(const std::size_t &task_count, const std::function<void(const std::size_t &)> &task) {
+                if (task_count == 0) {
+                    return;
+                }
+                if (this->workers.empty() || task_count == 1) {
+                    for (std::size_t i = 0; i < task_count; i++) {
+                        task(i);
+                    }
+                    return;
+                }
+
+                {
+                    std::unique_lock<std::mutex> lock(this->mutex);
+                    this->task = &task;
+                    this->task_count = task_count;
+                    this->next_task = 0;
+                    this->active_workers = this->workers.size();
+                    this->generation++;
+                }
+                this->start_condition.notify_all();
+                this->work();
+
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->done_condition.wait(lock, [&]() {
+                    return this->active_workers == 0;
+                });
+                this->task = nullptr;
+            }
+            /** Split a range of indices into fixed-size chunks and run the chunks as a batch
+             * \param count The amount of indices
+             * \param chunk_size The amount of indices per chunk (the chunks don't depend on the amount of threads, so per-chunk results can be merged in a fixed order)
+             * \param function The function to run for each chunk (given the first index and one past the last index of the chunk)
+             */
+            void run_chunked(const std::size_t &count, const std::size_t &chunk_size, const std::function<void(const std::size_t &, const std::size_t &)> &function) {
+                const std::size_t size = chunk_size == 0 ? 1 : chunk_size;
+                this->run((count + size - 1) / size, [&](const std::size_t &chunk) {
+                    function(chunk * size, std::min(count, (chunk + 1) * size));
+                });
+            }
+    };
+}
+
+#endif // BENGINE_WORKER_POOL_hpp
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cmath>
@@ -52,6 +53,9 @@ class player_top_down {
         double get_bottom_y() const {
             return this->collider.get_bottom_y();
         }
+        const bengine::basic_collider_2d &get_collider() const {
+            return this->collider;
+        }
 
         void set_x_pos(const double &x_pos) {
             this->collider.set_x_pos(x_pos);
@@ -163,12 +167,14 @@ class raycaster : public bengine::loop {
             int toggle_minimap = SDL_SCANCODE_M;
             int cycle_minimap_position = SDL_SCANCODE_P;
             int toggle_debug_screen = SDL_SCANCODE_F3;
+            int toggle_torch = SDL_SCANCODE_T;
         } keybinds;
 
-        bengine::basic_texture minimap_texture;
         TTF_Font *font = TTF_OpenFont("dev/fonts/GNU-Unifont.ttf", 20);
+        // \brief Glyphs of the font, rasterized once so that the debug text can be redrawn every frame without creating any textures
+        bengine::glyph_atlas font_atlas = bengine::glyph_atlas(this->font);
 
-        std::vector<std::vector<Uint8>> grid;
+        std::unique_ptr<bengine::grid_2d> grid;
 
         /** 8-bit bitmask containing settings for the minimap
          * 
@@ -185,13 +191,78 @@ class raycaster : public bengine::loop {
         Uint8 minimap_settings = 3;
         Uint8 minimap_cell_size = 16;
         Uint16 minimap_side_length = 360;
+        // \brief The view cone drawn on the minimap, and how many rays it is cut down to before rendering (0 to keep one per screen column)
+        bengine::ray_fan_2d ray_fan;
+        std::size_t ray_fan_max_rays = 256;
         bool show_debug_screen = false;
+        // \brief The 3D view, minimap and debug screen are each cached on their own layer, so that only the ones that changed are re-rendered
+        bengine::compositor layers;
+        std::size_t view_layer = this->layers.add_layer();
+        std::size_t minimap_layer = this->layers.add_layer();
+        std::size_t debug_layer = this->layers.add_layer();
+        // \brief Picks the resolution of the 3D view (as a fraction of the window's) so that frames stay within budget; the view is rendered at that resolution and stretched over the window
+        bengine::resolution_scaler view_scaler;
+        // \brief Whether the last frame re-rendered the 3D view (frames that only stacked the cached view say nothing about how expensive it is)
+        bool view_redrawn = false;
+        // \brief The camera (and map) that the walls were last cast with
+        struct wall_pass_key {
+            double x_pos = -1;
+            double y_pos = -1;
+            double angle = 0;
+            double fov = 0;
+            double view_distance = 0;
+            int width = 0;
+            std::uint64_t grid_version = 0;
+
+            bool operator==(const wall_pass_key &rhs) const {
+                return this->x_pos == rhs.x_pos && this->y_pos == rhs.y_pos && this->angle == rhs.angle && this->fov == rhs.fov && this->view_distance == rhs.view_distance && this->width == rhs.width && this->grid_version == rhs.grid_version;
+            }
+        } wall_pass;
+        /** The result of the wall pass: where the ray of each column of the 3D view hit (if it did) and how far away that is along the view direction (the depth buffer)
+         *
+         * Casting is skipped while the camera and map match this->wall_pass, so the 3D view can be relit (and the minimap/debug layers re-rendered) without casting a single ray
+         */
+        std::vector<std::optional<bengine::grid_2d::ray_hit>> wall_hits;
+        std::vector<double> wall_depths;
+        // \brief The hits of the pass before, which columns are reprojected from while the camera turns
+        std::vector<std::optional<bengine::grid_2d::ray_hit>> previous_wall_hits;
 
         player_raycaster player;
         player_raycaster minimap_player = player_raycaster(this->minimap_side_length / 2, this->minimap_side_length / 2, this->player.get_rotation());
         bengine::hitscanner_2d hitscanner;
 
         std::vector<bengine::basic_collider_2d> colliders;
+        // \brief Broadphase over this->colliders (each collider's ID matches its index)
+        bengine::spatial_hash_2d collider_hash = bengine::spatial_hash_2d(2);
+        // \brief Reused output of collider_hash queries
+        std::vector<std::size_t> nearby_colliders;
+        // \brief Threads shared by the parallel parts of the engine
+        bengine::worker_pool workers;
+        // \brief Every body that moves on its own (NPCs, projectiles, etc)
+        bengine::physics_world_2d world;
+        // \brief The area that the player can currently see (regardless of which way they are looking)
+        bengine::visibility_polygon_2d visibility;
+        // \brief Which cells the player has seen so far; unexplored cells are hidden on the minimap
+        bengine::fog_of_war_2d fog;
+        // \brief The minimap image, painted in tiles around whatever part of the map is viewed (only repainting cells that were revealed or edited since the last frame)
+        bengine::tiled_canvas_2d minimap_tiles;
+        // \brief Where the player was (and how far they could see) the last time the fog was revealed
+        double reveal_x_pos = -1, reveal_y_pos = -1, reveal_range = -1;
+        const SDL_Color minimap_fog_color = {32, 32, 32, 255};
+        // \brief Lights that move (just the one carried by the player), which are computed every frame on top of the lightmap
+        bengine::lighting_2d lighting;
+        std::size_t player_light = 0;
+        // \brief Fixed lights, only used to bake the lightmap
+        bengine::lighting_2d baked_lighting;
+        // \brief How lit every floor/wall is by the fixed lights (loaded from lightmap_path if it matches the map, otherwise baked at startup)
+        bengine::lightmap_2d lightmap;
+        const std::string lightmap_path = "lightmap.blm";
+        // \brief Torches that the player can place/pick up, lit with a (cheap) flood fill rather than shadows
+        bengine::flood_light_2d torches = bengine::flood_light_2d(15);
+        // \brief How bright a torch is at its own cell
+        const double torch_brightness = 0.5;
+        // \brief How many strips the floor below each wall column is split into (each strip is lit separately)
+        const Uint8 floor_strips = 4;
 
         double calc_move_angle(const bool &f, const bool &b, const bool &l, const bool &r) {
             if (f && !b) {
@@ -223,6 +294,7 @@ class raycaster : public bengine::loop {
                     if (!this->event.key.repeat) {
                         if (this->keystate[this->keybinds.toggle_debug_screen]) {
                             this->show_debug_screen = !this->show_debug_screen;
+                            this->layers.set_visible(this->debug_layer, this->show_debug_screen);
                             this->visuals_changed = true;
                         }
                         if (this->keystate[this->keybinds.toggle_minimap]) {
@@ -231,11 +303,25 @@ class raycaster : public bengine::loop {
                             } else {
                                 this->minimap_settings = bengine::bitwise_manipulator::activate_bits<Uint8>(this->minimap_settings, 1);
                             }
+                            this->layers.set_visible(this->minimap_layer, bengine::bitwise_manipulator::get_bit_state<Uint8>(this->minimap_settings, 0));
                             this->visuals_changed = true;
                         }
+                        if (this->keystate[this->keybinds.toggle_torch]) {
+                            const std::size_t col = this->player.get_x_pos(), row = this->player.get_y_pos();
+                            if (this->torches.get_source_level(col, row) > 0) {
+                                this->torches.remove_source(col, row);
+                            } else {
+                                this->torches.add_source(col, row, this->torches.get_max_level());
+                            }
+                            if (this->torches.get_changed_count() > 0) {
+                                this->layers.invalidate(this->view_layer);
+                                this->visuals_changed = true;
+                            }
+                        }
                         if (this->keystate[this->keybinds.cycle_minimap_position]) {
                             this->minimap_settings = bengine::bitwise_manipulator::set_subvalue<Uint8>(this->minimap_settings, (bengine::bitwise_manipulator::get_subvalue<Uint8>(this->minimap_settings, 1, 2) + 1) % 4, 1, 2);
                             if (bengine::bitwise_manipulator::get_bit_state<Uint8>(this->minimap_settings, 0)) {
+                                this->layers.invalidate(this->minimap_layer);
                                 this->visuals_changed = true;
                             }
                         }
@@ -250,20 +336,26 @@ class raycaster : public bengine::loop {
 
             if (this->calc_move_angle(this->keystate[this->keybinds.move_forwards], this->keystate[this->keybinds.move_backwards], this->keystate[this->keybinds.strafe_left], this->keystate[this->keybinds.strafe_right]) >= 0) {
                 const double move_angle = this->calc_move_angle(this->keystate[this->keybinds.move_forwards], this->keystate[this->keybinds.move_backwards], this->keystate[this->keybinds.strafe_left], this->keystate[this->keybinds.strafe_right]) - this->player.get_rotation() - C_PI_2;
-                this->player.move_x(this->player.get_movespeed() * std::cos(move_angle) * this->delta_time);
-                this->player.move_y(-this->player.get_movespeed() * std::sin(move_angle) * this->delta_time);
+                // The movement is swept against nearby colliders so that fast movement/long ticks can't tunnel through thin walls
+                bengine::basic_collider_2d moved_collider = this->player.get_collider();
+                this->collider_hash.move_and_slide(moved_collider, this->player.get_movespeed() * std::cos(move_angle) * this->delta_time, -this->player.get_movespeed() * std::sin(move_angle) * this->delta_time);
+                this->player.set_x_pos(moved_collider.get_x_pos());
+                this->player.set_y_pos(moved_collider.get_y_pos());
                 this->hitscanner.set_x_pos(this->player.get_x_pos());
                 this->hitscanner.set_y_pos(this->player.get_y_pos());
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             }
 
             if (this->keystate[this->keybinds.look_left]) {
                 player.look_cw(this->player.get_look_speed() * this->delta_time);
                 this->hitscanner.set_angle(this->hitscanner.get_angle() - this->player.get_look_speed() * this->delta_time);
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             } else if (this->keystate[this->keybinds.look_right]) {
                 player.look_ccw(this->player.get_look_speed() * this->delta_time);
                 this->hitscanner.set_angle(this->hitscanner.get_angle() + this->player.get_look_speed() * this->delta_time);
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             }
             if (this->keystate[this->keybinds.zoom_in]) {
@@ -272,141 +364,287 @@ class raycaster : public bengine::loop {
                     this->player.set_view_distance(1);
                 }
                 this->hitscanner.set_range(this->player.get_view_distance());
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             } else if (this->keystate[this->keybinds.zoom_out]) {
                 this->player.set_view_distance(this->player.get_view_distance() + this->player.get_zoom_speed() * this->delta_time);
                 this->hitscanner.set_range(this->player.get_view_distance());
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             }
             if (this->keystate[this->keybinds.shrink_fov]) {
                 this->player.set_fov(this->player.get_fov() - this->player.get_zoom_speed() * this->delta_time);
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             } else if (this->keystate[this->keybinds.grow_fov]) {
                 this->player.set_fov(this->player.get_fov() + this->player.get_zoom_speed() * this->delta_time);
+                this->layers.invalidate_all();
                 this->visuals_changed = true;
             }
 
-            for (std::size_t i = 0; i < this->colliders.size(); i++) {
-                if (this->player.fix_collision(this->colliders[i], bengine::basic_collider_2d::fix_mode::MOVE_SELF, true)) {
+            this->world.step(this->delta_time);
+
+            // Sweeping keeps the player from moving into colliders, so this only does anything when the player starts out overlapping one (like when spawning inside of a wall)
+            // Only colliders near the player can push it; the search area is padded by the player's size since each push can move the player by up to that much
+            this->nearby_colliders.clear();
+            this->collider_hash.query_aabb(bengine::basic_collider_2d(this->player.get_x_pos(), this->player.get_y_pos(), this->player.get_diameter() * 3, this->player.get_diameter() * 3), this->nearby_colliders);
+            for (const std::size_t &id : this->nearby_colliders) {
+                if (this->player.fix_collision(this->colliders[id], bengine::basic_collider_2d::fix_mode::MOVE_SELF, true)) {
                     this->hitscanner.set_x_pos(this->player.get_x_pos());
                     this->hitscanner.set_y_pos(this->player.get_y_pos());
+                    this->layers.invalidate_all();
                     this->visuals_changed = true;
                 }
             }
-        }
 
-        void create_minimap_texture() {
-            this->window.target_renderer_at_dummy();
-            this->window.initialize_dummy(this->grid.at(0).size() * minimap_cell_size, this->grid.size() * minimap_cell_size);
-            this->window.clear_renderer();
+            this->reveal_surroundings();
 
-            for (std::size_t row = 0; row < this->grid.size(); row++) {
-                for (std::size_t col = 0; col < this->grid.at(0).size(); col++) {
-                    if (grid.at(row).at(col) > 0) {
-                        this->window.fill_rectangle(col * minimap_cell_size, row * minimap_cell_size, minimap_cell_size, minimap_cell_size, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE));
-                    }
-                }
+            this->lighting.set_light_position(this->player_light, this->player.get_x_pos(), this->player.get_y_pos());
+            this->lighting.set_light_radius(this->player_light, this->player.get_view_distance());
+            if (this->lighting.update() > 0) {
+                this->layers.invalidate(this->view_layer);
+                this->visuals_changed = true;
             }
-            this->window.present_renderer();
+        }
 
-            this->minimap_texture.set_texture(this->window.duplicate_dummy());
-            this->window.target_renderer_at_window();
-            this->window.clear_renderer();
+        // \brief Get the color of a point lit by the lightmap (baked_level) and this->lighting (scale darkens/brightens the result, e.g. for floors)
+        SDL_Color get_lit_color(const double &baked_level, const double &x_pos, const double &y_pos, const double &scale = 1) const {
+            const Uint8 brightness = std::clamp((baked_level + this->lighting.get_light_level(x_pos, y_pos)) * scale, 0.0, 1.0) * 255;
+            return {brightness, brightness, brightness, 255};
         }
-        void render() override {
-            std::vector<std::optional<bengine::coordinate_2d<double>>> raycast_collisions;
-            const double original_hitscanner_angle = this->hitscanner.get_angle();
-            for (double angle = -this->player.get_fov() / 2; angle <= this->player.get_fov() / 2; angle += this->player.get_fov() / this->window.get_width()) {
-                this->hitscanner.set_angle(original_hitscanner_angle + angle);
-                raycast_collisions.emplace_back(this->hitscanner.get_hit(this->colliders));
-                if (!raycast_collisions.back().has_value()) {
-                    continue;
-                }
-                const bengine::fast_vector_2d<double> projection(std::fabs(player.get_x_pos() - raycast_collisions.back().value().get_x_pos()), std::fabs(player.get_y_pos() - raycast_collisions.back().value().get_y_pos()));
-                const double distance = projection.get_magnitude() * std::cos(angle);
 
-                const unsigned char rectangle_brightness = bengine::math_helper::map_value_to_range<double, unsigned char>(distance, 0, player.get_view_distance(), 255, 0);
-                const int rectangle_height = bengine::math_helper::map_value_to_range<double, int>(distance, 0, player.get_view_distance(), this->window.get_height(), 0);
-                this->window.fill_rectangle(raycast_collisions.size(), this->window.get_height_2() - rectangle_height / 2, 1, rectangle_height, {rectangle_brightness, rectangle_brightness, rectangle_brightness, 255});
+        // \brief Reveal the fog around the player (only if they moved or can see further than last time)
+        void reveal_surroundings() {
+            if (this->player.get_x_pos() == this->reveal_x_pos && this->player.get_y_pos() == this->reveal_y_pos && this->player.get_view_distance() <= this->reveal_range) {
+                return;
             }
-            this->hitscanner.set_angle(original_hitscanner_angle);
-
-            // Minimap rendering
-            if (bengine::bitwise_manipulator::get_bit_state<Uint8>(this->minimap_settings, 0)) {
-                const Uint16 minimap_corner_offset = 32;
-                const Uint16 minimap_x_pos = bengine::bitwise_manipulator::get_subvalue<Uint8>(this->minimap_settings, 1, 2) % 2 == 0 ? minimap_corner_offset : this->window.get_width() - this->minimap_side_length - minimap_corner_offset;
-                const Uint16 minimap_y_pos = bengine::bitwise_manipulator::get_subvalue<Uint8>(this->minimap_settings, 1, 2) <= 1 ? minimap_corner_offset : this->window.get_height() - this->minimap_side_length - minimap_corner_offset;
-                
-                const double view_distance = this->player.get_view_distance() * 2 > this->grid.size() || this->player.get_view_distance() * 2 > this->grid.at(0).size() ? std::min(this->grid.size(), this->grid.at(0).size()) / 2 : this->player.get_view_distance();
-                const Uint16 minimap_view_x_pos = this->player.get_x_pos() - view_distance < 0 ? 0 : (this->player.get_x_pos() + view_distance > this->grid.at(0).size() ? (this->grid.at(0).size() - view_distance * 2) * this->minimap_cell_size : (this->player.get_x_pos() - view_distance) * this->minimap_cell_size);
-                const Uint16 minimap_view_y_pos = this->player.get_y_pos() - view_distance < 0 ? 0 : (this->player.get_y_pos() + view_distance > this->grid.size() ? (this->grid.size() - view_distance * 2) * this->minimap_cell_size : (this->player.get_y_pos() - view_distance) * this->minimap_cell_size);
-                const double minimap_scale_factor = this->minimap_side_length / (2 * view_distance * this->minimap_cell_size) * this->minimap_cell_size;
-
-                if (this->player.get_x_pos() < view_distance) {
-                    this->minimap_player.set_x_pos(this->player.get_x_pos() * minimap_scale_factor);
-                } else if (this->player.get_x_pos() > this->grid.at(0).size() - view_distance) {
-                    this->minimap_player.set_x_pos(this->minimap_side_length - (this->grid.at(0).size() - this->player.get_x_pos()) * minimap_scale_factor);
-                }
-                if (this->player.get_y_pos() < view_distance) {
-                    this->minimap_player.set_y_pos(this->player.get_y_pos() * minimap_scale_factor);
-                } else if (this->player.get_y_pos() > this->grid.size() - view_distance) {
-                    this->minimap_player.set_y_pos(this->minimap_side_length - (this->grid.size() - this->player.get_y_pos()) * minimap_scale_factor);
+            this->reveal_x_pos = this->player.get_x_pos();
+            this->reveal_y_pos = this->player.get_y_pos();
+            this->reveal_range = this->player.get_view_distance();
+
+            this->visibility.compute(this->reveal_x_pos, this->reveal_y_pos, this->reveal_range);
+            if (this->fog.reveal(this->visibility) > 0) {
+                for (const std::size_t &cell : this->fog.get_revealed_cells()) {
+                    this->minimap_tiles.mark_dirty(cell % this->grid->get_cols(), cell / this->grid->get_cols());
                 }
+                // Only the maps show the fog
+                this->layers.invalidate(this->minimap_layer, this->get_minimap_area());
+                this->layers.invalidate(this->debug_layer, this->get_debug_map_area());
+                this->visuals_changed = true;
+            }
+        }
 
-                this->window.fill_rectangle(minimap_x_pos - this->minimap_side_length / 30, minimap_y_pos - this->minimap_side_length / 30, this->minimap_side_length + this->minimap_side_length / 15, this->minimap_side_length + this->minimap_side_length / 15, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::DARK_GRAY));
-                this->minimap_texture.set_frame({minimap_view_x_pos, minimap_view_y_pos, (int)(view_distance * this->minimap_cell_size * 2), (int)(view_distance * this->minimap_cell_size * 2)});
-                this->window.render_basic_texture(this->minimap_texture, {minimap_x_pos, minimap_y_pos, this->minimap_side_length, this->minimap_side_length});
-
-                for (std::size_t i = 0; i < raycast_collisions.size(); i++) {
-                    if (raycast_collisions.at(i).has_value()) {
-                        if (minimap_player.get_x_pos() + (raycast_collisions.at(i).value().get_x_pos() - this->player.get_x_pos()) * minimap_scale_factor < 0 || minimap_player.get_x_pos() + (raycast_collisions.at(i).value().get_x_pos() - this->player.get_x_pos()) * minimap_scale_factor > this->minimap_side_length || minimap_player.get_y_pos() + (raycast_collisions.at(i).value().get_y_pos() - this->player.get_y_pos()) * minimap_scale_factor < 0 || minimap_player.get_y_pos() + (raycast_collisions.at(i).value().get_y_pos() - this->player.get_y_pos()) * minimap_scale_factor > this->minimap_side_length) {
-                            const double angle = this->hitscanner.get_angle() - this->player.get_fov() / 2 + i * this->player.get_fov() / this->window.get_width();
-                            this->window.draw_line(minimap_x_pos + minimap_player.get_x_pos(), minimap_y_pos + minimap_player.get_y_pos(), minimap_x_pos + minimap_player.get_x_pos() + view_distance * std::cos(angle) * minimap_scale_factor, minimap_y_pos + minimap_player.get_y_pos() + view_distance * std::sin(angle) * minimap_scale_factor, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIGHT_GRAY));
-                        } else {
-                            this->window.draw_line(minimap_x_pos + minimap_player.get_x_pos(), minimap_y_pos + minimap_player.get_y_pos(), minimap_x_pos + minimap_player.get_x_pos() + (raycast_collisions.at(i).value().get_x_pos() - this->player.get_x_pos()) * minimap_scale_factor, minimap_y_pos + minimap_player.get_y_pos() + (raycast_collisions.at(i).value().get_y_pos() - this->player.get_y_pos()) * minimap_scale_factor, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIGHT_GRAY));
-                        }
-                    } else {
-                        if (this->hitscanner.get_range() >= 0) {
-                            const double angle = this->hitscanner.get_angle() - this->player.get_fov() / 2 + i * this->player.get_fov() / this->window.get_width();
-                            this->window.draw_line(minimap_x_pos + minimap_player.get_x_pos(), minimap_y_pos + minimap_player.get_y_pos(), minimap_x_pos + minimap_player.get_x_pos() + view_distance * std::cos(angle) * minimap_scale_factor, minimap_y_pos + minimap_player.get_y_pos() + view_distance * std::sin(angle) * minimap_scale_factor, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::DARK_GRAY));
-                        }
+        SDL_Color get_minimap_color(const std::size_t &col, const std::size_t &row) const {
+            if (!this->fog.is_explored(col, row)) {
+                return this->minimap_fog_color;
+            }
+            return bengine::render_window::get_color_from_preset(this->grid->is_solid(col, row) ? bengine::render_window::preset_color::WHITE : bengine::render_window::preset_color::BLACK);
+        }
+        // \brief Get the part of the window covered by the minimap (including its border)
+        SDL_Rect get_minimap_area() const {
+            const int minimap_corner_offset = 32, border = this->minimap_side_length / 30;
+            const int minimap_x_pos = bengine::bitwise_manipulator::get_subvalue<Uint8>(this->minimap_settings, 1, 2) % 2 == 0 ? minimap_corner_offset : this->window.get_width() - this->minimap_side_length - minimap_corner_offset;
+            const int minimap_y_pos = bengine::bitwise_manipulator::get_subvalue<Uint8>(this->minimap_settings, 1, 2) <= 1 ? minimap_corner_offset : this->window.get_height() - this->minimap_side_length - minimap_corner_offset;
+            return {minimap_x_pos - border, minimap_y_pos - border, this->minimap_side_length + this->minimap_side_length / 15, this->minimap_side_length + this->minimap_side_length / 15};
+        }
+        // \brief Get the part of the window covered by the map on the debug screen (only the part of the map that fits in the window is drawn)
+        SDL_Rect get_debug_map_area() const {
+            return {50, 50, std::min<int>(this->grid->get_cols() * this->minimap_cell_size, this->window.get_width() - 50), std::min<int>(this->grid->get_rows() * this->minimap_cell_size, this->window.get_height() - 50)};
+        }
+        /** Render part of the minimap
+         * \param view The part of the minimap to render (px at a scale of minimap_cell_size per cell for all 4 metrics)
+         * \param dst The portion of the window to render to (px for all 4 metrics)
+         */
+        void render_minimap(const SDL_Rect &view, const SDL_Rect &dst) {
+            this->minimap_tiles.render(this->window, view, dst, [&](const std::size_t &col, const std::size_t &row) {
+                return this->get_minimap_color(col, row);
+            });
+        }
+        /** Cast the ray of every column of the 3D view, unless the camera and map are the same as the last time they were cast
+         *
+         * When the camera only turned, each column is reprojected from the two columns of the last pass on either side of its new angle instead: if both hit the same face close enough that no whole cell fits between them, nothing can block the face in between, so the column hits it too (found without walking the grid); every other column (including ones between two misses, since a corner can poke into range between them) is cast
+         * \returns How many rays were cast
+         */
+        std::size_t cast_walls() {
+            const wall_pass_key key = {this->player.get_x_pos(), this->player.get_y_pos(), this->hitscanner.get_angle(), this->player.get_fov(), this->player.get_view_distance(), this->layers.get_width(this->view_layer), this->grid->get_version()};
+            if (key == this->wall_pass) {
+                return 0;
+            }
+            wall_pass_key turned = this->wall_pass;
+            turned.angle = key.angle;
+            const bool reproject = turned == key && !this->wall_hits.empty();
+            const double step = key.fov / key.width;
+            // How many columns the view has turned by
+            const double shift = std::remainder(key.angle - this->wall_pass.angle, C_2PI) / step;
+            this->wall_pass = key;
+            this->previous_wall_hits.swap(this->wall_hits);
+            this->wall_hits.clear();
+            this->wall_depths.clear();
+
+            std::size_t output = 0;
+            for (int i = 0; i <= key.width; i++) {
+                const double angle = -key.fov / 2 + i * step;
+                std::optional<bengine::grid_2d::ray_hit> hit;
+                bool found = false;
+                if (reproject && i + shift >= 0 && std::floor(i + shift) + 1 < this->previous_wall_hits.size()) {
+                    const std::size_t before = std::floor(i + shift);
+                    const std::optional<bengine::grid_2d::ray_hit> &lhs = this->previous_wall_hits[before], &rhs = this->previous_wall_hits[before + 1];
+                    if (lhs.has_value() && rhs.has_value() && lhs.value().col == rhs.value().col && lhs.value().row == rhs.value().row && lhs.value().vertical_face == rhs.value().vertical_face && std::max(lhs.value().distance, rhs.value().distance) * step < 1) {
+                        hit = this->grid->cast_ray_at_face(key.x_pos, key.y_pos, key.angle + angle, key.view_distance, lhs.value());
+                        found = hit.has_value();
                     }
                 }
-
-                minimap_player.set_radius(this->player.get_radius() * (this->minimap_side_length / (2 * view_distance * this->minimap_cell_size)) * this->minimap_cell_size);
-                this->window.fill_rectangle(minimap_x_pos + minimap_player.get_x_pos() - minimap_player.get_radius(), minimap_y_pos + minimap_player.get_y_pos() - minimap_player.get_radius(), minimap_player.get_radius() * 2, minimap_player.get_radius() * 2, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::RED));
+                if (!found) {
+                    // The grid is hit directly (rather than through the hitscanner) since the lightmap needs to know which face was hit
+                    hit = this->grid->cast_ray(key.x_pos, key.y_pos, key.angle + angle, key.view_distance);
+                    output++;
+                }
+                this->wall_hits.emplace_back(hit);
+                this->wall_depths.emplace_back(hit.has_value() ? hit.value().distance * std::cos(angle) : key.view_distance);
             }
+            return output;
+        }
+        // \brief Render the 3D view (lit by whatever the lights are now, with the walls cast by this->cast_walls)
+        void render_view_layer() {
+            this->cast_walls();
+            const double original_angle = this->hitscanner.get_angle();
+            // The view is rendered at its own resolution, which can be lower than the window's
+            const int height = this->layers.get_height(this->view_layer), height_2 = height / 2;
+            // Floor strips and walls never overlap, so they can be grouped by color
+            this->window.start_batching();
+            for (std::size_t i = 0; i < this->wall_hits.size(); i++) {
+                const double angle = -this->player.get_fov() / 2 + i * this->player.get_fov() / this->wall_pass.width;
+                const double x_dir = std::cos(original_angle + angle), y_dir = std::sin(original_angle + angle);
+                const double distance = this->wall_depths[i];
+
+                // The floor between the player and the wall is split into strips, each lit by whatever reaches the middle of the strip
+                for (Uint8 strip = 0; strip < this->floor_strips; strip++) {
+                    const double far_distance = distance * (this->floor_strips - strip) / this->floor_strips, near_distance = distance * (this->floor_strips - strip - 1) / this->floor_strips;
+                    const int strip_top = height_2 + bengine::math_helper::map_value_to_range<double, int>(far_distance, 0, player.get_view_distance(), height_2, 0);
+                    const int strip_bottom = height_2 + bengine::math_helper::map_value_to_range<double, int>(near_distance, 0, player.get_view_distance(), height_2, 0);
+                    const double middle_distance = (far_distance + near_distance) / 2 / std::cos(angle);
+                    const double middle_x_pos = this->player.get_x_pos() + x_dir * middle_distance, middle_y_pos = this->player.get_y_pos() + y_dir * middle_distance;
+                    this->window.fill_rectangle(i, strip_top, 1, strip_bottom - strip_top, this->get_lit_color(this->lightmap.get_floor_level(middle_x_pos, middle_y_pos) + this->torches.get_light_level(middle_x_pos, middle_y_pos) * this->torch_brightness, middle_x_pos, middle_y_pos, 0.5));
+                }
 
-            // Debug screen rendering
-            if (this->show_debug_screen) {
-                this->window.fill_rectangle(0, 0, 310, 25, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::BLACK));
-                this->window.render_text(this->font, bengine::string_helper::to_u16string("(" + bengine::string_helper::to_string_with_added_zeros<double>(this->player.get_x_pos(), 2, 5) + ", " + bengine::string_helper::to_string_with_added_zeros<double>(this->player.get_y_pos(), 2, 5) + ", " + bengine::string_helper::to_string_with_added_zeros<double>(this->hitscanner.get_angle() * U_180_PI, 3, 5) + ")").c_str(), 0, 0);
-                this->window.render_SDLTexture(this->minimap_texture.get_texture(), {0, 0, (int)(this->grid.at(0).size() * this->minimap_cell_size), (int)(this->grid.size() * this->minimap_cell_size)}, {50, 50, (int)(this->grid.at(0).size() * this->minimap_cell_size), (int)(this->grid.size() * this->minimap_cell_size)});
-            
-                for (std::size_t i = 0; i < this->colliders.size(); i++) {
-                    this->window.draw_rectangle(51 + this->colliders.at(i).get_left_x() * this->minimap_cell_size, 51 + this->colliders.at(i).get_bottom_y() * this->minimap_cell_size, this->colliders.at(i).get_width() * this->minimap_cell_size - 2, this->colliders.at(i).get_height() * this->minimap_cell_size - 2, {255, 0, 0, 255});
+                if (!this->wall_hits[i].has_value()) {
+                    continue;
                 }
+                const bengine::grid_2d::ray_hit &hit = this->wall_hits[i].value();
+                // Walls are lit from just in front of their face, since the face itself is exactly on the edge of every light's polygon
+                const double lit_x_pos = hit.position.get_x_pos() - x_dir * 1e-3, lit_y_pos = hit.position.get_y_pos() - y_dir * 1e-3;
+                const int rectangle_height = bengine::math_helper::map_value_to_range<double, int>(distance, 0, player.get_view_distance(), height, 0);
+                this->window.fill_rectangle(i, height_2 - rectangle_height / 2, 1, rectangle_height, this->get_lit_color(this->lightmap.get_face_level(hit, original_angle + angle) + this->torches.get_face_light_level(hit, original_angle + angle) * this->torch_brightness, lit_x_pos, lit_y_pos));
+            }
+            this->window.halt_batching();
+        }
+        // \brief Render the minimap in whichever corner it is set to
+        void render_minimap_layer() {
+            const SDL_Rect minimap_area = this->get_minimap_area();
+            const int minimap_x_pos = minimap_area.x + this->minimap_side_length / 30, minimap_y_pos = minimap_area.y + this->minimap_side_length / 30;
+
+            const double view_distance = this->player.get_view_distance() * 2 > this->grid->get_rows() || this->player.get_view_distance() * 2 > this->grid->get_cols() ? std::min(this->grid->get_rows(), this->grid->get_cols()) / 2 : this->player.get_view_distance();
+            const int minimap_view_x_pos = this->player.get_x_pos() - view_distance < 0 ? 0 : (this->player.get_x_pos() + view_distance > this->grid->get_cols() ? (this->grid->get_cols() - view_distance * 2) * this->minimap_cell_size : (this->player.get_x_pos() - view_distance) * this->minimap_cell_size);
+            const int minimap_view_y_pos = this->player.get_y_pos() - view_distance < 0 ? 0 : (this->player.get_y_pos() + view_distance > this->grid->get_rows() ? (this->grid->get_rows() - view_distance * 2) * this->minimap_cell_size : (this->player.get_y_pos() - view_distance) * this->minimap_cell_size);
+            const double minimap_scale_factor = this->minimap_side_length / (2 * view_distance * this->minimap_cell_size) * this->minimap_cell_size;
+
+            if (this->player.get_x_pos() < view_distance) {
+                this->minimap_player.set_x_pos(this->player.get_x_pos() * minimap_scale_factor);
+            } else if (this->player.get_x_pos() > this->grid->get_cols() - view_distance) {
+                this->minimap_player.set_x_pos(this->minimap_side_length - (this->grid->get_cols() - this->player.get_x_pos()) * minimap_scale_factor);
+            }
+            if (this->player.get_y_pos() < view_distance) {
+                this->minimap_player.set_y_pos(this->player.get_y_pos() * minimap_scale_factor);
+            } else if (this->player.get_y_pos() > this->grid->get_rows() - view_distance) {
+                this->minimap_player.set_y_pos(this->minimap_side_length - (this->grid->get_rows() - this->player.get_y_pos()) * minimap_scale_factor);
+            }
+
+            this->window.fill_rectangle(minimap_area.x, minimap_area.y, minimap_area.w, minimap_area.h, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::DARK_GRAY));
+            this->render_minimap({minimap_view_x_pos, minimap_view_y_pos, (int)(view_distance * this->minimap_cell_size * 2), (int)(view_distance * this->minimap_cell_size * 2)}, {minimap_x_pos, minimap_y_pos, this->minimap_side_length, this->minimap_side_length});
 
-                for (std::size_t i = 0; i < raycast_collisions.size(); i++) {
-                    if (raycast_collisions.at(i).has_value()) {
-                        this->window.draw_line(50 + this->hitscanner.get_x_pos() * this->minimap_cell_size, 50 + this->hitscanner.get_y_pos() * this->minimap_cell_size, 50 + raycast_collisions.at(i).value().get_x_pos() * this->minimap_cell_size, 50 + raycast_collisions.at(i).value().get_y_pos() * this->minimap_cell_size, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIME));
+            this->ray_fan.begin(minimap_x_pos + minimap_player.get_x_pos(), minimap_y_pos + minimap_player.get_y_pos(), bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIGHT_GRAY));
+            for (std::size_t i = 0; i < this->wall_hits.size(); i++) {
+                const double angle = this->hitscanner.get_angle() - this->player.get_fov() / 2 + i * this->player.get_fov() / this->wall_pass.width;
+                if (this->wall_hits.at(i).has_value()) {
+                    const double x_pos = minimap_player.get_x_pos() + (this->wall_hits.at(i).value().position.get_x_pos() - this->player.get_x_pos()) * minimap_scale_factor, y_pos = minimap_player.get_y_pos() + (this->wall_hits.at(i).value().position.get_y_pos() - this->player.get_y_pos()) * minimap_scale_factor;
+                    if (x_pos < 0 || x_pos > this->minimap_side_length || y_pos < 0 || y_pos > this->minimap_side_length) {
+                        this->ray_fan.add_ray(minimap_x_pos + minimap_player.get_x_pos() + view_distance * std::cos(angle) * minimap_scale_factor, minimap_y_pos + minimap_player.get_y_pos() + view_distance * std::sin(angle) * minimap_scale_factor, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIGHT_GRAY));
                     } else {
-                        if (this->hitscanner.get_range() >= 0) {
-                            const double angle = this->hitscanner.get_angle() - this->player.get_fov() / 2 + i * this->player.get_fov() / this->window.get_width();
-                            this->window.draw_line(50 + this->hitscanner.get_x_pos() * this->minimap_cell_size, 50 + this->hitscanner.get_y_pos() * this->minimap_cell_size, 50 + this->hitscanner.get_x_pos() * this->minimap_cell_size + this->hitscanner.get_range() * std::cos(angle) * this->minimap_cell_size, 50 + this->hitscanner.get_y_pos() * this->minimap_cell_size + this->hitscanner.get_range() * std::sin(angle) * this->minimap_cell_size, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::GREEN));
-                        }
+                        this->ray_fan.add_ray(minimap_x_pos + x_pos, minimap_y_pos + y_pos, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIGHT_GRAY));
                     }
+                } else if (this->hitscanner.get_range() >= 0) {
+                    this->ray_fan.add_ray(minimap_x_pos + minimap_player.get_x_pos() + view_distance * std::cos(angle) * minimap_scale_factor, minimap_y_pos + minimap_player.get_y_pos() + view_distance * std::sin(angle) * minimap_scale_factor, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::DARK_GRAY));
+                }
+            }
+            this->ray_fan.decimate(this->ray_fan_max_rays);
+            this->ray_fan.render(this->window);
+
+            minimap_player.set_radius(this->player.get_radius() * (this->minimap_side_length / (2 * view_distance * this->minimap_cell_size)) * this->minimap_cell_size);
+            this->window.fill_rectangle(minimap_x_pos + minimap_player.get_x_pos() - minimap_player.get_radius(), minimap_y_pos + minimap_player.get_y_pos() - minimap_player.get_radius(), minimap_player.get_radius() * 2, minimap_player.get_radius() * 2, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::RED));
+        }
+        // \brief Render the debug screen (the player's position/angle, plus the whole map with every collider and ray)
+        void render_debug_layer() {
+            this->window.fill_rectangle(0, 0, 310, 25, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::BLACK));
+            this->font_atlas.render_text(this->window, bengine::string_helper::to_u16string("(" + bengine::string_helper::to_string_with_added_zeros<double>(this->player.get_x_pos(), 2, 5) + ", " + bengine::string_helper::to_string_with_added_zeros<double>(this->player.get_y_pos(), 2, 5) + ", " + bengine::string_helper::to_string_with_added_zeros<double>(this->hitscanner.get_angle() * U_180_PI, 3, 5) + ")").c_str(), 0, 0);
+            const SDL_Rect debug_map_area = this->get_debug_map_area();
+            this->render_minimap({0, 0, debug_map_area.w, debug_map_area.h}, debug_map_area);
+        
+            this->window.start_batching();
+            for (std::size_t i = 0; i < this->colliders.size(); i++) {
+                this->window.draw_rectangle(51 + this->colliders.at(i).get_left_x() * this->minimap_cell_size, 51 + this->colliders.at(i).get_bottom_y() * this->minimap_cell_size, this->colliders.at(i).get_width() * this->minimap_cell_size - 2, this->colliders.at(i).get_height() * this->minimap_cell_size - 2, {255, 0, 0, 255});
+            }
+            this->window.halt_batching();
+
+            this->ray_fan.begin(50 + this->hitscanner.get_x_pos() * this->minimap_cell_size, 50 + this->hitscanner.get_y_pos() * this->minimap_cell_size, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIME));
+            for (std::size_t i = 0; i < this->wall_hits.size(); i++) {
+                if (this->wall_hits.at(i).has_value()) {
+                    this->ray_fan.add_ray(50 + this->wall_hits.at(i).value().position.get_x_pos() * this->minimap_cell_size, 50 + this->wall_hits.at(i).value().position.get_y_pos() * this->minimap_cell_size, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIME));
+                } else if (this->hitscanner.get_range() >= 0) {
+                    const double angle = this->hitscanner.get_angle() - this->player.get_fov() / 2 + i * this->player.get_fov() / this->wall_pass.width;
+                    this->ray_fan.add_ray(50 + this->hitscanner.get_x_pos() * this->minimap_cell_size + this->hitscanner.get_range() * std::cos(angle) * this->minimap_cell_size, 50 + this->hitscanner.get_y_pos() * this->minimap_cell_size + this->hitscanner.get_range() * std::sin(angle) * this->minimap_cell_size, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::GREEN));
                 }
+            }
+            this->ray_fan.decimate(this->ray_fan_max_rays);
+            this->ray_fan.render(this->window);
+
+            this->window.fill_rectangle(50 + (this->player.get_x_pos() - this->player.get_radius()) * this->minimap_cell_size, 50 + (this->player.get_y_pos() - this->player.get_radius()) * this->minimap_cell_size, this->player.get_radius() * this->minimap_cell_size * 2, this->player.get_radius() * this->minimap_cell_size * 2, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::RED));
+        }
 
-                this->window.fill_rectangle(50 + (this->player.get_x_pos() - this->player.get_radius()) * this->minimap_cell_size, 50 + (this->player.get_y_pos() - this->player.get_radius()) * this->minimap_cell_size, this->player.get_radius() * this->minimap_cell_size * 2, this->player.get_radius() * this->minimap_cell_size * 2, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::RED));
+        void render() override {
+            if (this->view_redrawn) {
+                this->view_scaler.update(this->render_time);
             }
+            this->layers.set_resolution(this->view_layer, this->view_scaler.apply(this->window.get_width()), this->view_scaler.apply(this->window.get_height()));
+            this->view_redrawn = this->layers.is_dirty(this->view_layer);
+            this->layers.render(this->window, [&](const std::size_t &layer) {
+                if (layer == this->view_layer) {
+                    this->render_view_layer();
+                } else if (layer == this->minimap_layer) {
+                    this->render_minimap_layer();
+                } else if (layer == this->debug_layer) {
+                    this->render_debug_layer();
+                }
+            });
         }
 
     public:
-        raycaster(const std::vector<std::vector<Uint8>> &grid) : bengine::loop("raycaster", 1280, 720, SDL_WINDOW_SHOWN /*| SDL_WINDOW_FULLSCREEN*/) {
+        raycaster(const std::vector<std::vector<Uint8>> &grid, const bengine::grid_2d::layout &grid_layout = bengine::grid_2d::layout::ROW_MAJOR) : bengine::loop("raycaster", 1280, 720, SDL_WINDOW_SHOWN /*| SDL_WINDOW_FULLSCREEN*/) {
+            switch (grid_layout) {
+                default:
+                case bengine::grid_2d::layout::ROW_MAJOR:
+                    this->grid = std::make_unique<bengine::row_major_grid_2d>();
+                    break;
+                case bengine::grid_2d::layout::TILED:
+                    this->grid = std::make_unique<bengine::tiled_grid_2d>();
+                    break;
+                case bengine::grid_2d::layout::SPARSE:
+                    this->grid = std::make_unique<bengine::sparse_grid_2d>();
+                    break;
+            }
+
             // in the case of an empty input grid, a 16x16 box is created as a "default"
             if (grid.empty()) {
-                this->grid = {
+                this->grid->load({
                     {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
                     {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
                     {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
@@ -423,47 +661,49 @@ class raycaster : public bengine::loop {
                     {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
                     {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
                     {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-                };
+                });
                 this->colliders.emplace_back(bengine::basic_collider_2d(8, 0.5, 16, 1));
                 this->colliders.emplace_back(bengine::basic_collider_2d(0.5, 8.5, 1, 15));
                 this->colliders.emplace_back(bengine::basic_collider_2d(15.5, 8.5, 1, 15));
                 this->colliders.emplace_back(bengine::basic_collider_2d(8, 15.5, 14, 1));
             } else {
                 // Basic copying of an input vector to and output, but also ensures that the output is rectangular
+                std::vector<std::vector<Uint8>> cells;
                 std::size_t longest_row_cols = 0;
                 for (std::size_t row = 0; row < grid.size(); row++) {
-                    this->grid.emplace_back();
+                    cells.emplace_back();
                     for (std::size_t col = 0; col < grid.at(row).size(); col++) {
-                        this->grid[row].emplace_back(grid.at(row).at(col));
+                        cells[row].emplace_back(grid.at(row).at(col));
                     }
-                    if (this->grid.at(row).size() > longest_row_cols) {
-                        longest_row_cols = this->grid.at(row).size();
+                    if (cells.at(row).size() > longest_row_cols) {
+                        longest_row_cols = cells.at(row).size();
                     }
                 }
-                for (std::size_t row = 0; row < this->grid.size(); row++) {
-                    for (std::size_t col = this->grid.at(row).size(); col < longest_row_cols; col++) {
-                        this->grid[row].emplace_back(0);
+                for (std::size_t row = 0; row < cells.size(); row++) {
+                    for (std::size_t col = cells.at(row).size(); col < longest_row_cols; col++) {
+                        cells[row].emplace_back(0);
                     }
                 }
+                this->grid->load(cells);
                 
                 // Algorithm to generate colliders with, making sure that any colliders that can be merged are merged
 
                 // Create a grid that will hold whether a cell has been visited or not
-                std::vector<std::vector<bool>> visit_grid(this->grid.size(), std::vector<bool>(this->grid.at(0).size(), false));
-                for (std::size_t row = 0; row < this->grid.size(); row++) {
-                    for (std::size_t col = 0; col < this->grid.at(0).size(); col++) {
-                        if (this->grid.at(row).at(col) == 0) {
+                std::vector<std::vector<bool>> visit_grid(this->grid->get_rows(), std::vector<bool>(this->grid->get_cols(), false));
+                for (std::size_t row = 0; row < this->grid->get_rows(); row++) {
+                    for (std::size_t col = 0; col < this->grid->get_cols(); col++) {
+                        if (!this->grid->is_solid(col, row)) {
                             visit_grid[row][col] = true;
                         }
                     }
                 }
 
                 std::size_t row_start = 0, col_start = 0;
-                while (row_start < this->grid.size() && col_start < this->grid.at(0).size()) {
+                while (row_start < this->grid->get_rows() && col_start < this->grid->get_cols()) {
                     // The new starting row/column is found by searching for the next spot that is unvisited
                     bool found_unvisited_cell = false;
-                    while (row_start < this->grid.size()) {
-                        while (col_start < this->grid.at(0).size()) {
+                    while (row_start < this->grid->get_rows()) {
+                        while (col_start < this->grid->get_cols()) {
                             if (!visit_grid.at(row_start).at(col_start)) {
                                 found_unvisited_cell = true;
                                 break;
@@ -483,7 +723,7 @@ class raycaster : public bengine::loop {
 
                     std::size_t row_end = row_start, col_end = col_start;
                     // First, start by going to the right until reached a cell visited before (which either means that its blank or has been used already; it can't be included in either case)
-                    while (col_end < this->grid.at(0).size()) {
+                    while (col_end < this->grid->get_cols()) {
                         if (visit_grid.at(row_end).at(col_end)) {
                             break;
                         }
@@ -491,7 +731,7 @@ class raycaster : public bengine::loop {
                         col_end++;
                     }
                     // Now the mesh has a width, so now we go down with that width until a row has a cell that has been visited before
-                    while (row_end < this->grid.size() - 1) {
+                    while (row_end < this->grid->get_rows() - 1) {
                         row_end++;
 
                         // Check to see if the next row is allowed to be added to the mesh
@@ -520,11 +760,41 @@ class raycaster : public bengine::loop {
                 }
             }
 
-            this->create_minimap_texture();
-            this->player.set_x_pos(this->grid.at(0).size() / 2);
-            this->player.set_y_pos(this->grid.size() / 2);
+            for (std::size_t i = 0; i < this->colliders.size(); i++) {
+                this->collider_hash.insert(this->colliders.at(i), true);
+            }
+            this->world.set_static_colliders(&this->collider_hash);
+            this->world.set_worker_pool(&this->workers);
+            this->visibility.load(*this->grid);
+            this->fog.resize(this->grid->get_cols(), this->grid->get_rows());
+
+            this->minimap_tiles.resize(this->grid->get_cols(), this->grid->get_rows(), this->minimap_cell_size);
+            this->layers.set_visible(this->minimap_layer, bengine::bitwise_manipulator::get_bit_state<Uint8>(this->minimap_settings, 0));
+            this->layers.set_visible(this->debug_layer, this->show_debug_screen);
+            this->player.set_x_pos(this->grid->get_cols() / 2);
+            this->player.set_y_pos(this->grid->get_rows() / 2);
             this->player.set_movespeed(0.25);
             this->hitscanner = bengine::hitscanner_2d(this->player.get_x_pos(), this->player.get_y_pos(), 0, this->player.get_view_distance(), false);
+            this->reveal_surroundings();
+
+            this->lighting.load(*this->grid);
+            this->torches.load(*this->grid);
+            this->player_light = this->lighting.add_light({this->player.get_x_pos(), this->player.get_y_pos(), this->player.get_view_distance(), 1});
+            this->lighting.update();
+
+            // A couple of fixed lights are placed in open space and baked (along with the ambient light) into the lightmap, unless a matching one was saved by an earlier run
+            this->baked_lighting.load(*this->grid);
+            this->baked_lighting.set_ambient_level(0.05);
+            for (const std::pair<std::size_t, std::size_t> &cell : {std::make_pair(this->grid->get_cols() / 4, this->grid->get_rows() / 4), std::make_pair(this->grid->get_cols() * 3 / 4, this->grid->get_rows() * 3 / 4)}) {
+                if (this->grid->is_in_bounds(cell.first, cell.second) && !this->grid->is_solid(cell.first, cell.second)) {
+                    this->baked_lighting.add_light({cell.first + 0.5, cell.second + 0.5, 6, 0.6});
+                }
+            }
+            if (this->lightmap.load(this->lightmap_path, *this->grid, bengine::lightmap_2d::get_signature(*this->grid, this->baked_lighting)) != 0) {
+                this->baked_lighting.update();
+                this->lightmap.bake(*this->grid, this->baked_lighting, &this->workers);
+                this->lightmap.save(this->lightmap_path, *this->grid, this->baked_lighting);
+            }
         }
         ~raycaster() {
             TTF_CloseFont(this->font);